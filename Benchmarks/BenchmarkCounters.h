@@ -0,0 +1,109 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Small helpers shared by the DunneCore benchmarks: a wall-clock timer, plus hardware cache-miss
+// counters where the OS exposes them to ordinary processes (Linux perf events). Elsewhere the
+// counters read as unavailable; on Apple platforms use Instruments' CPU Counters template.
+
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+namespace DunneCoreBenchmark
+{
+
+    struct CacheCounters
+    {
+        enum { L1D, LastLevel, counterCount };
+        int fd[counterCount];
+
+        CacheCounters()
+        {
+            for (int i=0; i < counterCount; i++) fd[i] = -1;
+#ifdef __linux__
+            const uint64_t cache[counterCount] = { PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_LL };
+            for (int i=0; i < counterCount; i++)
+            {
+                perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache[i] |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            }
+#endif
+        }
+
+        ~CacheCounters()
+        {
+#ifdef __linux__
+            for (int i=0; i < counterCount; i++) if (fd[i] >= 0) close(fd[i]);
+#endif
+        }
+
+        bool available(int which) const { return fd[which] >= 0; }
+
+        void start()
+        {
+#ifdef __linux__
+            for (int i=0; i < counterCount; i++)
+            {
+                if (fd[i] < 0) continue;
+                ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        void stop()
+        {
+#ifdef __linux__
+            for (int i=0; i < counterCount; i++) if (fd[i] >= 0) ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+        }
+
+        // returns -1 if the counter is unavailable
+        long long read(int which) const
+        {
+            long long count = -1;
+#ifdef __linux__
+            if (fd[which] < 0 || ::read(fd[which], &count, sizeof(count)) != sizeof(count)) count = -1;
+#endif
+            return count;
+        }
+    };
+
+    struct Stopwatch
+    {
+        std::chrono::steady_clock::time_point startTime;
+
+        void start() { startTime = std::chrono::steady_clock::now(); }
+
+        double elapsedSeconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+    };
+
+    // print a counter value and its rate per sample, or "n/a" if unavailable
+    inline void printCount(long long count, double sampleCount)
+    {
+        if (count < 0) printf(" %12s %9s", "n/a", "n/a");
+        else printf(" %12lld %9.4f", count, count / sampleCount);
+    }
+
+}
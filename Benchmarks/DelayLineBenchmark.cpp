@@ -0,0 +1,276 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Measures AdjustableDelayLine one sample at a time (push()) against whole blocks (process()),
+// at a fixed delay and with a per-sample modulated one, and the effects built on it: chorus and
+// flanger (ModulatedDelay), the chorus as a multi-tap ensemble, and StereoDelay, plain and
+// ping-pong. At a fixed delay, process() must
+// give exactly the same samples as push(). ModulatedDelay's LFO runs at a control rate; a null
+// test against a per-sample LFO checks that it can't be heard, at the default and the fastest
+// rate and full depth. Each interpolation kernel is then
+// timed, and its error measured on sines at a fractional delay. The program exits with status 1
+// if any check fails.
+
+#include "BenchmarkCounters.h"
+#include "AdjustableDelayLine.h"
+#include "FunctionTable.h"
+#include "ModulatedDelay.h"
+#include "ModulatedDelay_Defines.h"
+#include "ModulatedDelayNullTest.h"
+#include "StereoDelay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const double sampleRate = 44100.0;
+static const int sampleCount = 1 << 16;
+static const int blockSize = 64;
+static const int passes = 64;
+static const int runs = 3;
+static const double nullThresholdDb = -60.0;
+static const double interpolationThresholdDb = -60.0;   // for the higher orders, at 1 kHz
+
+static const char *interpolationNames[kDelayInterpolationCount] = { "linear", "allpass", "Hermite", "Lagrange" };
+
+static std::vector<float> input(int channel)
+{
+    std::vector<float> samples(sampleCount);
+    uint32_t random = 12345 + channel;
+    for (int i=0; i < sampleCount; i++)
+    {
+        random = random * 1664525u + 1013904223u;
+        samples[i] = (random >> 8) / 16777216.0f - 0.5f;
+    }
+    return samples;
+}
+
+// run body over the whole input passes times, best of several runs, in ns per sample
+template<typename Body>
+static double timeNsPerSample(Body body)
+{
+    double best = 0.0;
+    for (int r=0; r < runs; r++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+        for (int p=0; p < passes; p++) body();
+        double seconds = stopwatch.elapsedSeconds();
+        if (r == 0 || seconds < best) best = seconds;
+    }
+    return 1e9 * best / (double(passes) * sampleCount);
+}
+
+// A sine of frequencyHz through a fixed delay of 100.3 samples (at a fraction of exactly a half,
+// Hermite and Lagrange weights coincide): the difference from the exact delayed sine, relative
+// to it, in dB
+static double interpolationErrorDb(DelayInterpolation kind, double frequencyHz)
+{
+    const double delaySamples = 100.3;
+    const int settle = 1000;
+    AdjustableDelayLine line;
+    line.setInterpolation(kind);
+    line.init(sampleRate, 10.0);
+    line.setDelayMs(delaySamples * 1000.0 / sampleRate);
+
+    std::vector<float> sine(sampleCount), delayed(sampleCount);
+    double omega = 2.0 * M_PI * frequencyHz / sampleRate;
+    for (int i=0; i < sampleCount; i++) sine[i] = float(sin(omega * i));
+    line.process(sine.data(), delayed.data(), sampleCount);
+
+    double differencePower = 0.0, referencePower = 0.0;
+    for (int i=settle; i < sampleCount; i++)
+    {
+        double reference = sin(omega * (i - delaySamples));
+        differencePower += (delayed[i] - reference) * (delayed[i] - reference);
+        referencePower += reference * reference;
+    }
+    return 10.0 * log10(differencePower / referencePower + 1e-30);
+}
+
+static void report(const char *name, double nsPerSample)
+{
+    printf("%-32s %8.2f ns/sample\n", name, nsPerSample);
+}
+
+int main()
+{
+    bool isPassing = true;
+    std::vector<float> left = input(0), right = input(1);
+    std::vector<float> output(sampleCount), blockOutput(sampleCount);
+
+    AdjustableDelayLine line;
+    line.init(sampleRate, 1000.0);
+    line.setDelayMs(123.4);
+    line.setFeedback(0.5f);
+
+    report("push(), fixed delay", timeNsPerSample([&] {
+        for (int i=0; i < sampleCount; i++) output[i] = line.push(left[i]);
+    }));
+    report("process(), fixed delay", timeNsPerSample([&] {
+        for (int i=0; i < sampleCount; i += blockSize) line.process(&left[i], &blockOutput[i], blockSize);
+    }));
+
+    // identical output from the same starting state
+    line.clear();
+    for (int i=0; i < sampleCount; i++) output[i] = line.push(left[i]);
+    line.clear();
+    for (int i=0; i < sampleCount; i += blockSize) line.process(&left[i], &blockOutput[i], blockSize);
+    bool isIdentical = output == blockOutput;
+    if (!isIdentical) isPassing = false;
+    printf("%-32s %s\n\n", "process() matches push()", isIdentical ? "yes" : "NO");
+
+    std::vector<float> delaySamples(sampleCount);
+    for (int i=0; i < sampleCount; i++) delaySamples[i] = float(600.0 + 400.0 * sin(i * 0.0005));
+    report("setDelayMs() + push(), modulated", timeNsPerSample([&] {
+        for (int i=0; i < sampleCount; i++)
+        {
+            line.setDelayMs(delaySamples[i] * 1000.0 / sampleRate);
+            output[i] = line.push(left[i]);
+        }
+    }));
+    report("process(), modulated", timeNsPerSample([&] {
+        for (int i=0; i < sampleCount; i += blockSize)
+            line.process(&left[i], &blockOutput[i], &delaySamples[i], blockSize);
+    }));
+    printf("\n");
+
+    float *inBuffers[2] = { left.data(), right.data() };
+    std::vector<float> outLeft(sampleCount), outRight(sampleCount);
+    float *outBuffers[2] = { outLeft.data(), outRight.data() };
+
+    ModulatedDelay chorus(kChorus), flanger(kFlanger);
+    for (ModulatedDelay *pEffect : { &chorus, &flanger })
+    {
+        pEffect->init(2, sampleRate);
+        pEffect->setModDepthFraction(0.5f);
+        pEffect->setLeftFeedback(0.3f);
+        pEffect->setRightFeedback(0.3f);
+        pEffect->setDryWetMix(0.5f);
+    }
+    report("chorus, stereo", timeNsPerSample([&] { chorus.Render(2, sampleCount, inBuffers, outBuffers); }));
+    report("flanger, stereo", timeNsPerSample([&] { flanger.Render(2, sampleCount, inBuffers, outBuffers); }));
+
+    // an ensemble of N taps on one delay line per channel, against N whole choruses
+    for (int taps : { 4, kChorusMaxTapCount })
+    {
+        ModulatedDelay ensemble(kChorus);
+        ensemble.init(2, sampleRate);
+        ensemble.setModDepthFraction(0.5f);
+        ensemble.setDryWetMix(0.5f);
+        ensemble.setTapCount(taps);
+        char name[64];
+        snprintf(name, sizeof(name), "chorus, %d taps, stereo", taps);
+        report(name, timeNsPerSample([&] { ensemble.Render(2, sampleCount, inBuffers, outBuffers); }));
+        snprintf(name, sizeof(name), "%d choruses, stereo", taps);
+        report(name, timeNsPerSample([&] {
+            for (int t=0; t < taps; t++) chorus.Render(2, sampleCount, inBuffers, outBuffers);
+        }));
+    }
+
+    const float *constInBuffers[2] = { left.data(), right.data() };
+    for (bool isPingPong : { false, true })
+    {
+        StereoDelay delay;
+        delay.init(sampleRate, 2000.0);
+        delay.setDelayMs(123.4);
+        delay.setFeedback(0.5f);
+        delay.setPingPongMode(isPingPong);
+        report(isPingPong ? "StereoDelay, ping-pong" : "StereoDelay", timeNsPerSample([&] {
+            delay.render(sampleCount, constInBuffers, outBuffers);
+        }));
+    }
+
+    // The control-rate LFO must not be heard: its output must null against the per-sample one,
+    // at the default rate and depth, and at the fastest rate and full depth, which on white noise
+    // is the worst case, at each common sample rate.
+    printf("\nNull test against a per-sample LFO, difference relative to signal\n");
+    for (double nullSampleRate : { sampleRate, 48000.0, 96000.0 })
+    {
+        std::vector<float> tone(sampleCount);
+        for (int i=0; i < sampleCount; i++) tone[i] = float(0.5 * sin(i * 2.0 * M_PI * 440.0 / nullSampleRate));
+        for (ModulatedDelayType type : { kChorus, kFlanger })
+        {
+            const char *name = type == kChorus ? "chorus" : "flanger";
+            float defaultRate = type == kChorus ? kChorusDefaultModFreqHz : kFlangerDefaultModFreqHz;
+            float defaultDepth = type == kChorus ? kChorusDefaultDepth : kFlangerDefaultDepth;
+            float maxRate = type == kChorus ? kChorusMaxModFreqHz : kFlangerMaxModFreqHz;
+            float maxDepth = type == kChorus ? kChorusMaxDepth : kFlangerMaxDepth;
+            for (int signal=0; signal < 2; signal++)
+            {
+                const float *pSignal = signal == 0 ? tone.data() : left.data();
+                const char *signalName = signal == 0 ? "440 Hz sine" : "white noise";
+                for (bool isWorstCase : { false, true })
+                {
+                    double db = modulatedDelayNullTestDb(type, isWorstCase ? maxRate : defaultRate,
+                                                         isWorstCase ? maxDepth : defaultDepth,
+                                                         pSignal, sampleCount, nullSampleRate);
+                    bool isNull = db < nullThresholdDb;
+                    if (!isNull) isPassing = false;
+                    printf("%-8s %4.1f kHz %-12s %-19s %8.1f dB %s\n", name, nullSampleRate / 1000.0,
+                           signalName, isWorstCase ? "fastest, full depth" : "default rate, depth", db,
+                           isNull ? "" : "FAILS");
+                }
+            }
+        }
+    }
+
+    // The kernels: cost at a fixed and at a modulated delay, and in a stereo flanger, then error
+    printf("\nInterpolation kernels, ns/sample: fixed delay, modulated delay, flanger\n");
+    for (int k=0; k < kDelayInterpolationCount; k++)
+    {
+        DelayInterpolation kind = DelayInterpolation(k);
+        AdjustableDelayLine kernelLine;
+        kernelLine.setInterpolation(kind);
+        kernelLine.init(sampleRate, 1000.0);
+        kernelLine.setDelayMs(123.4);
+        kernelLine.setFeedback(0.5f);
+        double fixedNs = timeNsPerSample([&] {
+            for (int i=0; i < sampleCount; i += blockSize)
+                kernelLine.process(&left[i], &blockOutput[i], blockSize);
+        });
+
+        // process() must match push() with every kernel
+        kernelLine.clear();
+        for (int i=0; i < sampleCount; i++) output[i] = kernelLine.push(left[i]);
+        kernelLine.clear();
+        for (int i=0; i < sampleCount; i += blockSize) kernelLine.process(&left[i], &blockOutput[i], blockSize);
+        if (output != blockOutput)
+        {
+            isPassing = false;
+            printf("%-8s process() does NOT match push()\n", interpolationNames[k]);
+        }
+
+        double modulatedNs = timeNsPerSample([&] {
+            for (int i=0; i < sampleCount; i += blockSize)
+                kernelLine.process(&left[i], &blockOutput[i], &delaySamples[i], blockSize);
+        });
+
+        ModulatedDelay kernelFlanger(kFlanger);
+        kernelFlanger.setInterpolation(kind);
+        kernelFlanger.init(2, sampleRate);
+        kernelFlanger.setModDepthFraction(0.5f);
+        kernelFlanger.setLeftFeedback(0.3f);
+        kernelFlanger.setRightFeedback(0.3f);
+        kernelFlanger.setDryWetMix(0.5f);
+        double flangerNs = timeNsPerSample([&] { kernelFlanger.Render(2, sampleCount, inBuffers, outBuffers); });
+
+        printf("%-8s %8.2f %8.2f %8.2f\n", interpolationNames[k], fixedNs, modulatedNs, flangerNs);
+    }
+
+    printf("\nInterpolation error at a delay of 100.3 samples, relative to signal\n");
+    printf("%-8s %10s %10s %10s\n", "", "1 kHz", "5 kHz", "15 kHz");
+    for (int k=0; k < kDelayInterpolationCount; k++)
+    {
+        DelayInterpolation kind = DelayInterpolation(k);
+        double db1k = interpolationErrorDb(kind, 1000.0);
+        bool isAccurate = kind == kLinearInterpolation || db1k < interpolationThresholdDb;
+        if (!isAccurate) isPassing = false;
+        printf("%-8s %7.1f dB %7.1f dB %7.1f dB %s\n", interpolationNames[k], db1k,
+               interpolationErrorDb(kind, 5000.0), interpolationErrorDb(kind, 15000.0), isAccurate ? "" : "FAILS");
+    }
+
+    return isPassing ? 0 : 1;
+}
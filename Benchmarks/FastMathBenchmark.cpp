@@ -0,0 +1,148 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Accuracy and speed of the FastMath approximations (see FastMath.h).
+//
+// The accuracy check sweeps each function densely over its documented range, comparing it with
+// the double-precision standard library, and fails (exit status 1) if any error exceeds the bound
+// documented in FastMath.h. The timing compares the single-precision standard library with the
+// FastMath block versions, in ns per value over arrays of typical arguments.
+
+#include "BenchmarkCounters.h"
+#include "FastMath.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const int sweepCount = 1 << 22;
+static const int blockSize = 4096;
+static const int blockRepeats = 4000;
+static const int runs = 5;
+
+static bool isPassing = true;
+
+static void report(const char *name, const char *range, double error, const char *unit, double bound)
+{
+    bool isOK = error <= bound;
+    if (!isOK) isPassing = false;
+    printf("%-10s %-24s %12.3g %-8s (bound %.3g) %s\n", name, range, error, unit, bound, isOK ? "ok" : "FAIL");
+}
+
+// evenly spaced arguments from lo to hi
+static float sweepArg(double lo, double hi, int i)
+{
+    return float(lo + (hi - lo) * i / (sweepCount - 1));
+}
+
+static void checkAccuracy()
+{
+    double maxError = 0.0;
+    for (int i=0; i < sweepCount; i++)
+    {
+        float x = sweepArg(-126.0, 126.0, i);
+        maxError = fmax(maxError, fabs(fastExp2(x) / exp2(double(x)) - 1.0));
+    }
+    report("fastExp2", "[-126, 126]", maxError, "relative", 1.5e-7);
+    printf("%-10s %-24s %12.3g cents\n", "", "", 1200.0 * log2(1.0 + maxError));
+
+    maxError = 0.0;
+    for (int i=0; i < sweepCount; i++)
+    {
+        float x = float(exp2(sweepArg(-8.0, 8.0, i)));
+        maxError = fmax(maxError, fabs(fastLog2(x) - log2(double(x))));
+    }
+    report("fastLog2", "[2^-8, 2^8]", maxError, "octaves", 3e-7);
+    printf("%-10s %-24s %12.3g cents\n", "", "", 1200.0 * maxError);
+
+    // beyond 2^+-8, in float steps of the exact result
+    maxError = 0.0;
+    for (int i=0; i < sweepCount; i++)
+    {
+        float x = float(exp2(sweepArg(-125.9, 127.9, i)));
+        double exact = log2(double(x));
+        double step = nextafterf(float(fabs(exact)), INFINITY) - float(fabs(exact));
+        maxError = fmax(maxError, (fabs(fastLog2(x) - exact) - 3e-7) / step);
+    }
+    report("fastLog2", "[2^-126, 2^128)", maxError, "steps", 1.0);
+
+    maxError = 0.0;
+    for (int i=0; i < sweepCount; i++)
+    {
+        float x = sweepArg(-64.0 * M_PI, 64.0 * M_PI, i);
+        maxError = fmax(maxError, fabs(fastSin(x) - sin(double(x))));
+    }
+    report("fastSin", "[-64 pi, 64 pi]", maxError, "absolute", 5e-7);
+
+    maxError = 0.0;
+    double topError = 0.0;
+    for (int i=0; i < sweepCount; i++)
+    {
+        float x = sweepArg(0.0, 0.495 * M_PI, i);
+        double error = x == 0.0f ? 0.0 : fabs(fastTan(x) / tan(double(x)) - 1.0);
+        if (x <= 1.3f) maxError = fmax(maxError, error);
+        topError = fmax(topError, error);
+    }
+    report("fastTan", "[0, 1.3]", maxError, "relative", 1e-5);
+    report("fastTan", "[0, 0.495 pi]", topError, "relative", 7e-4);
+    printf("%-10s %-24s %12.3g dB\n", "", "", 20.0 * log10(1.0 + topError));
+}
+
+// best-of-runs ns per value of f over blockRepeats passes of input
+template<typename Function>
+static double timeBlocks(const std::vector<float>& input, Function f)
+{
+    std::vector<float> output(blockSize);
+    volatile float sink = 0.0f;
+    double best = 0.0;
+    for (int r=0; r < runs; r++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+        for (int n=0; n < blockRepeats; n++)
+        {
+            f(input.data(), output.data());
+            sink = sink + output[n % blockSize];
+        }
+        double t = stopwatch.elapsedSeconds();
+        if (r == 0 || t < best) best = t;
+    }
+    return 1e9 * best / (double(blockRepeats) * blockSize);
+}
+
+template<typename Function>
+static std::vector<float> arguments(Function argumentAt)
+{
+    std::vector<float> input(blockSize);
+    for (int i=0; i < blockSize; i++) input[i] = float(argumentAt(double(i) / blockSize));
+    return input;
+}
+
+static void timeFunction(const char *name, const std::vector<float>& input,
+                         float (*libraryFunction)(float), void (*blockFunction)(const float *, float *, int))
+{
+    double libraryNs = timeBlocks(input, [=](const float *pIn, float *pOut) {
+        for (int i=0; i < blockSize; i++) pOut[i] = libraryFunction(pIn[i]);
+    });
+    double fastNs = timeBlocks(input, [=](const float *pIn, float *pOut) {
+        blockFunction(pIn, pOut, blockSize);
+    });
+    printf("%-10s %14.2f %14.2f %10.1fx\n", name, libraryNs, fastNs, libraryNs / fastNs);
+}
+
+int main()
+{
+    printf("Accuracy, %d arguments per range\n\n", sweepCount);
+    checkAccuracy();
+
+    printf("\nns per value, blocks of %d\n\n", blockSize);
+    printf("%-10s %14s %14s %11s\n", "", "standard", "FastMath", "speedup");
+    timeFunction("exp2", arguments([](double u) { return 8.0 * u - 4.0; }), exp2f, fastExp2);
+    timeFunction("log2", arguments([](double u) { return exp2(8.0 * u - 4.0); }), log2f, fastLog2);
+    timeFunction("sin", arguments([](double u) { return 8.0 * M_PI * (u - 0.5); }), sinf, fastSin);
+    timeFunction("tan", arguments([](double u) { return 1.5 * u; }), tanf, fastTan);
+
+    return isPassing ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Checks the compile-time tables in LookupTables.h entry by entry against the libm expressions
+// they replaced, failing (exit status 1) on any difference, and times that libm work, which
+// used to run when the first filter was constructed or the first engine initialized.
+
+#include "BenchmarkCounters.h"
+#include "LookupTables.h"
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const int runs = 100;
+static volatile float sink;
+
+static float sineAt(int i) { return (float)(sin(double(i) / sineTableSize * 2.0 * M_PI)); }
+static float noteHzAt(int i) { return 440.0f * pow(2.0f, (i - 69.0f) / 12.0f); }
+
+template<int N>
+static int countDifferences(const char *name, const ConstantTable<N>& table, float (*valueAt)(int))
+{
+    int differences = 0;
+    for (int i=0; i < N; i++)
+    {
+        float expected = valueAt(i);
+        if (table[i] != expected)
+        {
+            if (differences++ < 10) printf("%s[%d] = %.9g, libm gives %.9g\n", name, i, table[i], expected);
+        }
+    }
+    printf("%-20s %5d entries, %d differ\n", name, N, differences);
+    return differences;
+}
+
+template<int N>
+static double computeSeconds(float (*valueAt)(int))
+{
+    static volatile float values[N];
+    double best = 0.0;
+    for (int r=0; r < runs; r++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+        for (int i=0; i < N; i++) values[i] = valueAt(i);
+        double t = stopwatch.elapsedSeconds();
+        if (r == 0 || t < best) best = t;
+    }
+    sink = values[N - 1];
+    return best;
+}
+
+int main()
+{
+    int differences = countDifferences("sineTable", sineTable, sineAt);
+    differences += countDifferences("noteFrequencyTable", noteFrequencyTable, noteHzAt);
+
+    printf("\nlibm time to compute them at run time: sine %.1f us, note frequencies %.1f us\n",
+           1e6 * computeSeconds<sineTableSize>(sineAt), 1e6 * computeSeconds<128>(noteHzAt));
+    return differences == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Cost of CoreSampler::render() with 32 voices held in their sustain segment, where all the
+// per-chunk control work (envelopes, LFOs, pitch and cutoff calculations) produces the same
+// results chunk after chunk:
+//
+//   pad      looped sample through the filter, with key tracking
+//   organ    looped sample, no filter
+//   vibrato  as pad, plus per-voice vibrato, so pitch and cutoff really change every chunk
+//   mono pad as pad, from a mono sample, which each voice filters as a single channel
+//   mono out as pad, rendered to a single output buffer
+//
+// It reports time per voice-sample of the whole render, and per voice-chunk of "control": the
+// same render() called with zero-sample chunks, which leaves only the voice loop and
+// SamplerVoice::prepToGetSamples(). Each is the best of several runs.
+
+#include "BenchmarkCounters.h"
+#include "CoreSampler.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace DunneCoreBenchmark;
+
+static const int voiceCount = 32;
+static const int chunkSize = 16;
+static const double sampleRate = 44100.0;
+static const double seconds = 10.0;
+static const int chunkCount = int(seconds * sampleRate) / chunkSize;
+static const int runs = 5;
+
+struct Config
+{
+    const char *name;
+    bool isFilterEnabled;
+    float voiceVibratoDepth;
+    int sourceChannels;
+    int outputChannels;
+};
+
+static void loadSample(CoreSampler& sampler, std::vector<float>& data, int channelCount)
+{
+    int frames = int(sampleRate);
+    data.resize(channelCount * frames);
+    for (int i=0; i < frames; i++)
+    {
+        data[channelCount * i] = 0.5f * sinf(0.0627f * i) + 0.2f * sinf(0.31f * i);
+        if (channelCount == 2) data[2 * i + 1] = 0.5f * sinf(0.0621f * i);
+    }
+
+    SampleDataDescriptor sdd;
+    memset(&sdd, 0, sizeof(sdd));
+    sdd.sampleDescriptor.noteNumber = 60;
+    sdd.sampleDescriptor.noteFrequency = 261.6f;
+    sdd.sampleDescriptor.minimumNoteNumber = 0;
+    sdd.sampleDescriptor.maximumNoteNumber = 127;
+    sdd.sampleDescriptor.minimumVelocity = 0;
+    sdd.sampleDescriptor.maximumVelocity = 127;
+    sdd.sampleDescriptor.isLooping = true;
+    sdd.sampleDescriptor.loopStartPoint = 0.2f;
+    sdd.sampleDescriptor.loopEndPoint = 0.9f;
+    sdd.sampleRate = float(sampleRate);
+    sdd.isInterleaved = channelCount > 1;
+    sdd.channelCount = channelCount;
+    sdd.sampleCount = frames;
+    sdd.data = data.data();
+    sampler.loadSampleData(sdd);
+    sampler.buildKeyMap();
+}
+
+// returns elapsed seconds for chunkCount chunks of renderSize samples, once all voices sustain
+static double renderOnce(const Config& config, int renderSize)
+{
+    CoreSampler sampler;
+    sampler.init(sampleRate);
+    std::vector<float> data;
+    loadSample(sampler, data, config.sourceChannels);
+
+    sampler.isFilterEnabled = config.isFilterEnabled;
+    sampler.voiceVibratoDepth = config.voiceVibratoDepth;
+    sampler.setADSRAttackDurationSeconds(0.01f);
+    sampler.setADSRDecayDurationSeconds(0.1f);
+    sampler.setADSRSustainFraction(0.7f);
+    sampler.setFilterDecayDurationSeconds(0.1f);
+    sampler.setFilterSustainFraction(0.3f);
+
+    float left[chunkSize], right[chunkSize];
+    float *outBuffers[2] = { left, right };
+    for (int v=0; v < voiceCount; v++) sampler.playNote(36 + 2 * v, 100);
+    for (int c=0; c < int(sampleRate) / chunkSize; c++) sampler.render(config.outputChannels, chunkSize, outBuffers);
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    for (int c=0; c < chunkCount; c++) sampler.render(config.outputChannels, renderSize, outBuffers);
+    return stopwatch.elapsedSeconds();
+}
+
+static double render(const Config& config, int renderSize)
+{
+    double best = renderOnce(config, renderSize);
+    for (int r=1; r < runs; r++)
+    {
+        double t = renderOnce(config, renderSize);
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+int main()
+{
+    const Config configs[] = {
+        { "pad",        true,   0.0f,   2,  2 },
+        { "organ",      false,  0.0f,   2,  2 },
+        { "vibrato",    true,   0.3f,   2,  2 },
+        { "mono pad",   true,   0.0f,   1,  2 },
+        { "mono out",   true,   0.0f,   2,  1 },
+    };
+
+    printf("%d sustained voices, %.0f s at %.0f Hz\n\n", voiceCount, seconds, sampleRate);
+    printf("%-10s %22s %21s\n", "", "render ns/voice-sample", "control ns/voice-chunk");
+
+    double voiceChunks = double(chunkCount) * voiceCount;
+    for (const Config& config : configs)
+    {
+        double renderSeconds = render(config, chunkSize);
+        double controlSeconds = render(config, 0);
+        printf("%-10s %22.2f %21.1f\n", config.name,
+               1e9 * renderSeconds / (voiceChunks * chunkSize), 1e9 * controlSeconds / voiceChunks);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Checks that CoreSynth renders are reproducible across threads, and measures how rendering
+// scales with render threads (CoreSynth::setRenderThreadCount()) and polyphony.
+//
+// The oscillators' random starting phases come from per-voice CounterRandom streams (see
+// CounterRandom.h), so a synth's output depends only on its seed and the notes it plays. The
+// first check renders a reference on the main thread, then the same seed on several threads at
+// once; every render must match the reference bit for bit, and a different seed must differ.
+//
+// The scaling table renders 8, 16 and 32 voices on 1 to N render threads, N being the hardware
+// thread count (up to maxThreads), in ns per voice-sample of wall-clock time, best of several
+// runs; each render must match the one with a single thread. The program exits with status 1 if
+// any check fails.
+
+#include "BenchmarkCounters.h"
+#include "CoreSynth.h"
+#include "LookupTables.h"
+
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace DunneCoreBenchmark;
+
+static const int chunkSize = 16;
+static const double sampleRate = 44100.0;
+static const double seconds = 4.0;
+static const int chordNoteCount = 24;
+static const int instanceCount = 4;
+static const int maxThreads = 8;
+static const int runs = 3;
+
+static bool isPassing = true;
+
+// render a held chord of noteCount voices, then release it, into a buffer of left then right
+static std::vector<float> render(unsigned seed, int threadCount, int noteCount, double *pSeconds = nullptr)
+{
+    CoreSynth synth;
+    synth.setRandomSeed(seed);
+    synth.setRenderThreadCount(threadCount);
+    synth.init(sampleRate);
+    synth.setAmpReleaseDurationSeconds(0.5f);
+
+    const int chunkCount = int(seconds * sampleRate) / chunkSize;
+    std::vector<float> output(2 * chunkCount * chunkSize, 0.0f);
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    for (int n=0; n < noteCount; n++) synth.playNote(24 + 2 * n, 100, DunneCore::noteFrequencyTable[24 + 2 * n]);
+    for (int c=0; c < chunkCount; c++)
+    {
+        if (c == chunkCount / 2)
+            for (int n=0; n < noteCount; n++) synth.stopNote(24 + 2 * n, false);
+        float *outBuffers[2] = { &output[c * chunkSize], &output[(chunkCount + c) * chunkSize] };
+        synth.render(2, chunkSize, outBuffers);
+    }
+    if (pSeconds) *pSeconds = stopwatch.elapsedSeconds();
+    return output;
+}
+
+static void checkInstances()
+{
+    const double voiceSamples = seconds * sampleRate * chordNoteCount;
+    printf("%d voices, %.0f s at %.0f Hz\n\n", chordNoteCount, seconds, sampleRate);
+
+    double referenceSeconds;
+    std::vector<float> reference = render(1, 1, chordNoteCount, &referenceSeconds);
+    printf("%-24s %8.2f ns/voice-sample\n", "main thread", 1e9 * referenceSeconds / voiceSamples);
+
+    std::vector<float> outputs[instanceCount];
+    double threadSeconds[instanceCount];
+    std::vector<std::thread> threads;
+    for (int t=0; t < instanceCount; t++)
+        threads.emplace_back([&, t] { outputs[t] = render(1, 1, chordNoteCount, &threadSeconds[t]); });
+    for (auto& thread : threads) thread.join();
+
+    for (int t=0; t < instanceCount; t++)
+    {
+        bool isIdentical = outputs[t] == reference;
+        if (!isIdentical) isPassing = false;
+        printf("thread %d of %-13d %8.2f ns/voice-sample, %s\n", t + 1, instanceCount,
+               1e9 * threadSeconds[t] / voiceSamples, isIdentical ? "identical" : "DIFFERS");
+    }
+
+    bool isSeedUsed = render(2, 1, chordNoteCount) != reference;
+    if (!isSeedUsed) isPassing = false;
+    printf("\nanother seed %s\n", isSeedUsed ? "differs, as it should" : "gives the SAME output");
+}
+
+static void measureScaling()
+{
+    const int noteCounts[] = { 8, 16, 32 };
+    int threadLimit = int(std::thread::hardware_concurrency());
+    if (threadLimit < 1) threadLimit = 1;
+    if (threadLimit > maxThreads) threadLimit = maxThreads;
+
+    printf("\nRender threads: ns/voice-sample\n\n");
+    printf("%-8s", "threads");
+    for (int noteCount : noteCounts) printf(" %9d voices", noteCount);
+    printf("\n");
+
+    std::vector<float> reference[3];
+    for (int threadCount=1; threadCount <= threadLimit; threadCount++)
+    {
+        printf("%-8d", threadCount);
+        for (int k=0; k < 3; k++)
+        {
+            double best = 0.0;
+            std::vector<float> output;
+            for (int r=0; r < runs; r++)
+            {
+                double t;
+                output = render(1, threadCount, noteCounts[k], &t);
+                if (r == 0 || t < best) best = t;
+            }
+            if (threadCount == 1) reference[k] = output;
+            bool isIdentical = output == reference[k];
+            if (!isIdentical) isPassing = false;
+            printf(" %12.2f %s", 1e9 * best / (seconds * sampleRate * noteCounts[k]), isIdentical ? "  " : "!!");
+        }
+        printf("\n");
+    }
+    printf("\n(!! marks output differing from one thread)\n");
+}
+
+int main()
+{
+    checkInstances();
+    measureScaling();
+    return isPassing ? 0 : 1;
+}
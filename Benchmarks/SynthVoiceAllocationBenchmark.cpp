@@ -0,0 +1,86 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Measures CoreSynth note-on cost and render cost against the number of voices
+// (CoreSynth::setVoiceCount()). Notes arrive faster than they finish, so once the pool fills up
+// every note-on steals a voice, half the time from one in its release and half from a held one.
+// Free and stolen voices come from VoiceAllocator's lists, and the voice already playing a note
+// from a per-note index, so a note event should cost the same at any voice count. A note played
+// again while releasing takes a fresh voice, so pools beyond 128 voices fill up too.
+
+#include "BenchmarkCounters.h"
+#include "CoreSynth.h"
+#include "LookupTables.h"
+
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCoreBenchmark;
+
+static const int chunkSize = 16;
+static const double sampleRate = 44100.0;
+static const double seconds = 2.0;
+static const int notesPerChunk = 4;
+static const int runs = 3;
+
+struct Result
+{
+    double eventSeconds, renderSeconds;
+    long long noteOnCount;
+};
+
+static Result run(int voiceCount)
+{
+    CoreSynth synth;
+    synth.setVoiceCount(voiceCount);
+    synth.init(sampleRate);
+    synth.setAmpReleaseDurationSeconds(1.0f);
+
+    const int chunkCount = int(seconds * sampleRate) / chunkSize;
+    std::vector<float> left(chunkSize), right(chunkSize);
+    float *outBuffers[2] = { left.data(), right.data() };
+
+    Result result = { 0.0, 0.0, 0 };
+    Stopwatch stopwatch;
+    int note = 0;
+    for (int c=0; c < chunkCount; c++)
+    {
+        stopwatch.start();
+        for (int n=0; n < notesPerChunk; n++, note++)
+        {
+            // hold every other note, so the pool holds active and releasing voices
+            int noteNumber = 12 + note % 96;
+            synth.playNote(noteNumber, 100, DunneCore::noteFrequencyTable[noteNumber]);
+            if (note % 2) synth.stopNote(noteNumber, false);
+            result.noteOnCount++;
+        }
+        result.eventSeconds += stopwatch.elapsedSeconds();
+
+        stopwatch.start();
+        synth.render(2, chunkSize, outBuffers);
+        result.renderSeconds += stopwatch.elapsedSeconds();
+    }
+    return result;
+}
+
+int main()
+{
+    const int voiceCounts[] = { 16, 32, 64, 128, 256, 512 };
+
+    printf("%d note-ons per %d-sample chunk, %.0f s at %.0f Hz, best of %d\n\n",
+           notesPerChunk, chunkSize, seconds, sampleRate, runs);
+    printf("%-8s %16s %16s\n", "voices", "ns/note event", "ns/sample");
+    for (int voiceCount : voiceCounts)
+    {
+        Result best;
+        for (int r=0; r < runs; r++)
+        {
+            Result result = run(voiceCount);
+            if (r == 0 || result.eventSeconds < best.eventSeconds) best.eventSeconds = result.eventSeconds;
+            if (r == 0 || result.renderSeconds < best.renderSeconds) best.renderSeconds = result.renderSeconds;
+            best.noteOnCount = result.noteOnCount;
+        }
+        printf("%-8d %16.1f %16.1f\n", voiceCount, 1e9 * best.eventSeconds / best.noteOnCount,
+               1e9 * best.renderSeconds / (seconds * sampleRate));
+    }
+    return 0;
+}
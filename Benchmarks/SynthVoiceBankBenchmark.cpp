@@ -0,0 +1,167 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Compares the CoreSynth per-voice gain/filter/mix stage in its two layouts, at 32 voices:
+// array-of-structures, i.e. a stereo MultiStageFilter per voice, run one voice at a time,
+// versus structure-of-arrays, i.e. SynthVoiceBank, which runs each step across all voices.
+// Both must produce identical output; that is checked too.
+
+#include "BenchmarkCounters.h"
+#include "MultiStageFilter.h"
+#include "SynthVoiceBank.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const int voiceCount = 32;
+static const int filterStages = 2;
+static const int chunkSize = 16;
+static const double sampleRate = 44100.0;
+static const double seconds = 20.0;
+static const double resLinear = 2.0;
+
+// Deterministic oscillator output, cutoffs and gains, so both layouts see exactly the same input
+struct Source
+{
+    float oscillator[2][chunkSize][voiceCount];
+    double cutoffHz[voiceCount];
+    float gain[voiceCount];
+    unsigned seed = 1;
+
+    float random() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f; }
+
+    void next(int chunkIndex)
+    {
+        for (int ch=0; ch < 2; ch++)
+            for (int i=0; i < chunkSize; i++)
+                for (int v=0; v < voiceCount; v++)
+                    oscillator[ch][i][v] = random() - 0.5f;
+        for (int v=0; v < voiceCount; v++)
+        {
+            // filter EG sweeps each voice's cutoff; most chunks need new coefficients
+            cutoffHz[v] = 200.0 + 8000.0 * (0.5 + 0.5 * sin(0.01 * chunkIndex + v));
+            gain[v] = 0.5f + 0.01f * v;
+        }
+    }
+};
+
+struct AoS
+{
+    MultiStageFilter filter[voiceCount];
+
+    AoS()
+    {
+        for (int v=0; v < voiceCount; v++)
+        {
+            filter[v].init(sampleRate);
+            filter[v].setStages(filterStages);
+        }
+    }
+
+    void render(const Source& source, float *pLeft, float *pRight)
+    {
+        for (int v=0; v < voiceCount; v++)
+        {
+            float left[chunkSize], right[chunkSize];
+            for (int i=0; i < chunkSize; i++)
+            {
+                left[i] = source.gain[v] * source.oscillator[0][i][v];
+                right[i] = source.gain[v] * source.oscillator[1][i][v];
+            }
+            filter[v].setParameters(source.cutoffHz[v], resLinear);
+            filter[v].process(left, right, chunkSize);
+            for (int i=0; i < chunkSize; i++)
+            {
+                pLeft[i] += left[i];
+                pRight[i] += right[i];
+            }
+        }
+    }
+};
+
+struct SoA
+{
+    SynthVoiceBank bank;
+
+    SoA() { bank.init(sampleRate); }
+
+    void render(const Source& source, float *pLeft, float *pRight)
+    {
+        for (int v=0; v < voiceCount; v++)
+        {
+            bank.isActive[v] = true;
+            bank.gain[v] = source.gain[v];
+            bank.setFilterParameters(v, source.cutoffHz[v], resLinear);
+            for (int ch=0; ch < 2; ch++)
+                for (int i=0; i < chunkSize; i++)
+                    bank.input[ch][i][v] = source.oscillator[ch][i][v];
+        }
+        bank.process(chunkSize, voiceCount, filterStages, pLeft, pRight);
+    }
+};
+
+// consumes the input only, to measure the overhead common to both layouts
+struct InputOnly
+{
+    void render(const Source& source, float *pLeft, float *pRight)
+    {
+        for (int i=0; i < chunkSize; i++)
+        {
+            for (int v=0; v < voiceCount; v++)
+            {
+                pLeft[i] += source.oscillator[0][i][v];
+                pRight[i] += source.oscillator[1][i][v];
+            }
+        }
+    }
+};
+
+template<typename Layout>
+static void run(const char *name, CacheCounters& counters, std::vector<float>& output)
+{
+    Layout layout;
+    Source source;
+    const int chunkCount = int(seconds * sampleRate) / chunkSize;
+    output.assign(2 * chunkCount * chunkSize, 0.0f);
+
+    // generating the input is part of the timed loop; see InputOnly
+    Stopwatch stopwatch;
+    counters.start();
+    stopwatch.start();
+    for (int c=0; c < chunkCount; c++)
+    {
+        source.next(c);
+        float *pLeft = &output[2 * c * chunkSize];
+        layout.render(source, pLeft, pLeft + chunkSize);
+    }
+    double elapsed = stopwatch.elapsedSeconds();
+    counters.stop();
+
+    double voiceSamples = double(chunkCount) * chunkSize * voiceCount;
+    printf("%-4s %10.2f", name, 1e9 * elapsed / voiceSamples);
+    printCount(counters.read(CacheCounters::L1D), voiceSamples);
+    printCount(counters.read(CacheCounters::LastLevel), voiceSamples);
+    printf("\n");
+}
+
+int main()
+{
+    CacheCounters counters;
+    std::vector<float> aosOutput, soaOutput;
+
+    printf("%d voices, %d filter stages, %.0f s at %.0f Hz; miss counts are per voice-sample\n\n",
+           voiceCount, filterStages, seconds, sampleRate);
+    printf("%-4s %10s %12s %9s %12s %9s\n", "", "ns/sample", "L1D misses", "/sample", "LL misses", "/sample");
+
+    std::vector<float> unused;
+    run<InputOnly>("none", counters, unused);
+    run<AoS>("AoS", counters, aosOutput);
+    run<SoA>("SoA", counters, soaOutput);
+
+    bool identical = aosOutput == soaOutput;
+    printf("\noutputs %s\n", identical ? "identical" : "DIFFER");
+    return identical ? 0 : 1;
+}
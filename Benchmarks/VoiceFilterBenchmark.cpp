@@ -0,0 +1,168 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Compares the voice filter types (see VoiceFilter.h) under heavy filter-envelope modulation:
+// a resonant filter on noise, with its cutoff swept between 60 Hz and 15 kHz by a fast,
+// constantly retriggered envelope, updated once per 16-sample chunk as in the sampler and synth.
+//
+// For each type it reports the cost per sample of one stereo voice (VoiceFilter, as used by
+// SamplerVoice) and per voice-sample of 32 voices in a SynthVoiceBank, including coefficient
+// updates. "peak" is the largest output sample, as a check on stability. The sampler uses one
+// stage, and does not offer the ladder, whose single-voice cost is about three times biquad x1's.
+
+#include "BenchmarkCounters.h"
+#include "SynthVoiceBank.h"
+#include "VoiceFilter.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const int voiceCount = 32;
+static const int chunkSize = 16;
+static const double sampleRate = 44100.0;
+static const double seconds = 10.0;
+static const double resLinear = 0.3;       // about +10 dB
+
+static const int chunkCount = int(seconds * sampleRate) / chunkSize;
+static const int sampleCount = chunkCount * chunkSize;
+
+// Cutoff of voice 0 per sample: attack 2 ms, exponential decay over about 30 ms, retriggered
+// every 50 ms, spanning 8 octaves. Other voices follow the same curve, offset in time.
+static std::vector<double> cutoffCurve()
+{
+    std::vector<double> cutoffHz(sampleCount);
+    for (int i=0; i < sampleCount; i++)
+    {
+        double t = fmod(i / sampleRate, 0.05);
+        double env = t < 0.002 ? t / 0.002 : exp(-(t - 0.002) / 0.01);
+        cutoffHz[i] = 60.0 * pow(2.0, 8.0 * env);
+    }
+    return cutoffHz;
+}
+static const std::vector<double> cutoffHz = cutoffCurve();
+
+static double cutoffAt(int sampleIndex, int voice)
+{
+    return cutoffHz[(sampleIndex + 163 * voice * chunkSize) % sampleCount];
+}
+
+static float noise(unsigned& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 16777216.0f - 0.5f;
+}
+
+struct Config
+{
+    const char *name;
+    VoiceFilter::FilterType type;
+    int stages;
+};
+
+// one voice, controlled every chunk; returns elapsed seconds
+static double renderVoice(const Config& config, std::vector<float>& output)
+{
+    VoiceFilter filter;
+    filter.init(sampleRate);
+    filter.setType(config.type);
+    filter.setStages(config.stages);
+
+    output.assign(2 * sampleCount, 0.0f);
+    unsigned seed = 1;
+    for (int i=0; i < sampleCount; i++)
+    {
+        output[2 * i] = noise(seed);
+        output[2 * i + 1] = noise(seed);
+    }
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    float left[chunkSize], right[chunkSize];
+    for (int start=0; start < sampleCount; start += chunkSize)
+    {
+        filter.setParameters(cutoffAt(start, 0), resLinear);
+        for (int i=0; i < chunkSize; i++)
+        {
+            left[i] = output[2 * (start + i)];
+            right[i] = output[2 * (start + i) + 1];
+        }
+        filter.process(left, right, chunkSize);
+        for (int i=0; i < chunkSize; i++)
+        {
+            output[2 * (start + i)] = left[i];
+            output[2 * (start + i) + 1] = right[i];
+        }
+    }
+    return stopwatch.elapsedSeconds();
+}
+
+// all voices in a SynthVoiceBank, controlled every chunk; returns elapsed seconds
+static double renderBank(const Config& config, std::vector<float>& output)
+{
+    SynthVoiceBank bank;
+    bank.init(sampleRate);
+    bank.setFilterType(config.type);
+    for (int v=0; v < voiceCount; v++)
+    {
+        bank.isActive[v] = true;
+        bank.gain[v] = 0.5f;
+    }
+
+    output.assign(2 * sampleCount, 0.0f);
+    unsigned seed = 1;
+
+    // generating the input is part of the timed loop, as the oscillators would be
+    Stopwatch stopwatch;
+    stopwatch.start();
+    for (int c=0; c < chunkCount; c++)
+    {
+        for (int v=0; v < voiceCount; v++)
+            bank.setFilterParameters(v, cutoffAt(c * chunkSize, v), resLinear);
+        for (int ch=0; ch < 2; ch++)
+            for (int i=0; i < chunkSize; i++)
+                for (int v=0; v < voiceCount; v++)
+                    bank.input[ch][i][v] = noise(seed);
+
+        float *pLeft = &output[2 * c * chunkSize];
+        bank.process(chunkSize, voiceCount, config.stages, pLeft, pLeft + chunkSize);
+    }
+    return stopwatch.elapsedSeconds();
+}
+
+static float peak(const std::vector<float>& x)
+{
+    float p = 0.0f;
+    for (float v : x) if (fabsf(v) > p || v != v) p = v != v ? INFINITY : fabsf(v);
+    return p;
+}
+
+int main()
+{
+    const Config configs[] = {
+        { "biquad x1",  VoiceFilter::kResonantLowPass,  1 },
+        { "biquad x2",  VoiceFilter::kResonantLowPass,  2 },
+        { "SVF x1",     VoiceFilter::kStateVariable,    1 },
+        { "SVF x2",     VoiceFilter::kStateVariable,    2 },
+        { "ladder",     VoiceFilter::kLadder,           1 },
+    };
+
+    printf("cutoff 60 Hz - 15 kHz every 50 ms, resonance %.1f dB, %.0f s at %.0f Hz\n\n",
+           -20.0 * log10(resLinear), seconds, sampleRate);
+    printf("%-10s %12s %14s %10s %10s\n", "", "1 voice ns", "32 voices ns", "peak", "bank peak");
+
+    std::vector<float> voiceOutput, bankOutput;
+    for (const Config& config : configs)
+    {
+        double voiceSeconds = renderVoice(config, voiceOutput);
+        double bankSeconds = renderBank(config, bankOutput);
+
+        printf("%-10s %12.2f %14.2f %10.2f %10.2f\n", config.name,
+               1e9 * voiceSeconds / sampleCount,
+               1e9 * bankSeconds / (double(sampleCount) * voiceCount),
+               peak(voiceOutput), peak(bankOutput));
+    }
+    return 0;
+}
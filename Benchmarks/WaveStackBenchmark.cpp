@@ -0,0 +1,145 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// Compares WaveStack table resolutions (and octave crossfading) at full CoreSynth polyphony.
+// Each of 32 voices reads the same three waveforms CoreSynth uses: osc1 and osc2 as single
+// phases, and osc3 as 9 drawbar harmonics, at notes spread across the keyboard. Reported are
+// time per voice-sample, and L1D/last-level cache read misses where available (see
+// BenchmarkCounters.h). Build instructions are in README.md.
+
+#include "BenchmarkCounters.h"
+#include "FunctionTable.h"
+#include "WaveStack.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace DunneCore;
+using namespace DunneCoreBenchmark;
+
+static const int voiceCount = 32;
+static const int chunkSize = 16;
+static const int drawbarHarmonics[] = { 1, 2, 3, 4, 6, 8, 10, 12, 16 };
+static const int drawbarCount = sizeof(drawbarHarmonics) / sizeof(drawbarHarmonics[0]);
+static const int phasesPerVoice = 2 + drawbarCount;
+static const double sampleRate = 44100.0;
+static const double seconds = 20.0;
+
+static float sink;  // keeps the optimizer from discarding the render loop
+
+template<int bits>
+struct Voices
+{
+    typedef WaveStackT<bits> Stack;
+
+    std::shared_ptr<const Stack> stacks[3];
+
+    const Stack *pStack[voiceCount][phasesPerVoice];
+    int octave[voiceCount][phasesPerVoice];
+    float octaveFade[voiceCount][phasesPerVoice];
+    uint32_t phase[voiceCount][phasesPerVoice];
+    uint32_t phaseIncrement[voiceCount][phasesPerVoice];
+
+    Voices()
+    {
+        FunctionTable waveform;
+        waveform.init(Stack::tableLength);
+        waveform.sawtooth(0.2f);
+        stacks[0] = Stack::getShared(waveform.waveTable);
+        waveform.square(0.4f, 0.01f);
+        stacks[1] = Stack::getShared(waveform.waveTable);
+        waveform.triangle(0.5f);
+        stacks[2] = Stack::getShared(waveform.waveTable);
+
+        unsigned seed = 12345;
+        for (int v=0; v < voiceCount; v++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            int noteNumber = 24 + int((seed >> 16) % 73);  // C1 to C7
+            double noteHz = 440.0 * pow(2.0, (noteNumber - 69) / 12.0);
+            for (int p=0; p < phasesPerVoice; p++)
+            {
+                int harmonic = p < 2 ? 1 : drawbarHarmonics[p - 2];
+                pStack[v][p] = stacks[p < 2 ? p : 2].get();
+                float phaseDelta = float(harmonic * noteHz / sampleRate);
+                phase[v][p] = uint32_t(4294967296.0 * p / phasesPerVoice);
+                phaseIncrement[v][p] = Stack::phaseIncrement(phaseDelta);
+                octave[v][p] = Stack::octaveFor(phaseDelta, &octaveFade[v][p]);
+                if (octave[v][p] >= bits) octave[v][p] = bits - 1;
+            }
+        }
+    }
+
+    template<bool crossfade>
+    void render(int sampleCount)
+    {
+        float out[chunkSize];
+        for (int done=0; done < sampleCount; done += chunkSize)
+        {
+            for (int i=0; i < chunkSize; i++) out[i] = 0.0f;
+            for (int v=0; v < voiceCount; v++)
+            {
+                for (int i=0; i < chunkSize; i++)
+                {
+                    float sample = 0.0f;
+                    for (int p=0; p < phasesPerVoice; p++)
+                    {
+                        if (crossfade)
+                            sample += pStack[v][p]->interp(octave[v][p], phase[v][p], octaveFade[v][p]);
+                        else
+                            sample += pStack[v][p]->interp(octave[v][p], phase[v][p]);
+                        phase[v][p] += phaseIncrement[v][p];
+                    }
+                    out[i] += sample;
+                }
+            }
+            sink += out[chunkSize - 1];
+        }
+    }
+};
+
+template<int bits, bool crossfade>
+static void run(CacheCounters& counters)
+{
+    Voices<bits> voices;
+    const int sampleCount = int(seconds * sampleRate) / chunkSize * chunkSize;
+    voices.template render<crossfade>(sampleCount / 20);     // warm up
+
+    Stopwatch stopwatch;
+    counters.start();
+    stopwatch.start();
+    voices.template render<crossfade>(sampleCount);
+    double elapsed = stopwatch.elapsedSeconds();
+    counters.stop();
+
+    const int stackBytes = 2 * WaveStackT<bits>::tableLength * int(sizeof(float));
+    double voiceSamples = double(sampleCount) * voiceCount;
+    printf("%5d %6d %8d  %-3s %10.2f %8.1fx",
+           WaveStackT<bits>::tableLength, stackBytes, 3 * stackBytes, crossfade ? "on" : "off",
+           1e9 * elapsed / voiceSamples, sampleCount / sampleRate / elapsed);
+    printCount(counters.read(CacheCounters::L1D), voiceSamples);
+    printCount(counters.read(CacheCounters::LastLevel), voiceSamples);
+    printf("\n");
+}
+
+int main()
+{
+    CacheCounters counters;
+
+    printf("%d voices x %d phases, %.0f s at %.0f Hz; miss counts are per voice-sample\n\n",
+           voiceCount, phasesPerVoice, seconds, sampleRate);
+    printf("%5s %6s %8s  %-3s %10s %9s %12s %9s %12s %9s\n",
+           "size", "stack", "3 stacks", "xf", "ns/sample", "realtime",
+           "L1D misses", "/sample", "LL misses", "/sample");
+
+    run<9, false>(counters);
+    run<9, true>(counters);
+    run<10, false>(counters);
+    run<10, true>(counters);
+    run<11, false>(counters);
+    run<11, true>(counters);
+    run<12, false>(counters);
+    run<12, true>(counters);
+
+    return sink == 12345.0f;
+}
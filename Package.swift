@@ -24,7 +24,7 @@ let package = Package(
                 "DunneCore/README.md",
             ],
             cxxSettings: [.headerSearchPath("DunneCore/Common")]),
-        .testTarget(name: "DunneAudioKitTests", dependencies: ["DunneAudioKit"], resources: [.copy("TestResources/")]),
+        .testTarget(name: "DunneAudioKitTests", dependencies: ["DunneAudioKit", "CDunneAudioKit"], resources: [.copy("TestResources/")]),
     ],
     cxxLanguageStandard: .cxx14
 )
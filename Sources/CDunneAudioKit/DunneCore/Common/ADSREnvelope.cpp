@@ -19,6 +19,7 @@ namespace DunneCore
         decaySamples = decaySeconds * sampleRateHz;
         sustainFraction = susFraction;
         releaseSamples = releaseSeconds * sampleRateHz;
+        updateSegments();
     }
 
     void ADSREnvelopeParameters::init(float newSampleRateHz, float attackSeconds, float decaySeconds, float susFraction, float releaseSeconds)
@@ -34,57 +35,51 @@ namespace DunneCore
         attackSamples *= scaleFactor;
         decaySamples *= scaleFactor;
         releaseSamples *= scaleFactor;
+        updateSegments();
     }
 
-
-    void ADSREnvelope::init(CurvatureType curvatureType)
+    void ADSREnvelopeParameters::updateSegments()
     {
-        int silenceSamples = int(0.01 * pParameters->sampleRateHz);     // always 10 mSec
-        int attackSamples = int(pParameters->attackSamples);
-        int decaySamples = int(pParameters->decaySamples);
-        double sustainFraction = double(pParameters->sustainFraction);
-        int releaseSamples = int(pParameters->releaseSamples);
-
-        envDesc.clear();
-        envDesc.push_back({ 0.0, 0.0, 0.0, -1 });               // kIdle: 0 forever
-        envDesc.push_back({ 1.0, 0.0, 0.0, silenceSamples });   // kSilence in 10 mSec
-
-        if (curvatureType == kAnalogLike)
-        {
-            envDesc.push_back({ 0.0, 1.0, exp(-1.5), attackSamples });                  // kAttack
-            envDesc.push_back({ 1.0, sustainFraction, exp(-4.95), decaySamples });      // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });           // kSustain
-            envDesc.push_back({ sustainFraction, 0.0, exp(-4.95), releaseSamples });    // kRelease
-        }
-        else if (curvatureType == kLinearInDb)
+        int silenceSamples = int(0.01 * sampleRateHz);     // always 10 mSec
+        int attackSamples = int(this->attackSamples);
+        int decaySamples = int(this->decaySamples);
+        double sustainFraction = double(this->sustainFraction);
+        int releaseSamples = int(this->releaseSamples);
+
+        // The segments are shared with envelopes which may be running, so they are overwritten in
+        // place, never reallocated. kSilence and kRelease always start wherever the envelope is,
+        // so their initial value of 1.0 only marks them as sloped, not flat.
+        for (int curvatureType = ADSREnvelope::kLinear; curvatureType <= ADSREnvelope::kLinearInDb; curvatureType++)
         {
-            envDesc.push_back({ 0.0, 1.0, 0.99999, attackSamples });                    // kAttack
-            envDesc.push_back({ 1.0, sustainFraction, exp(-11.05), decaySamples });     // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });           // kSustain
-            envDesc.push_back({ sustainFraction, 0.0, exp(-11.05), releaseSamples });   // kRelease
+            double attackTco = 0.0, decayTco = 0.0;
+            if (curvatureType == ADSREnvelope::kAnalogLike)
+            {
+                attackTco = exp(-1.5);
+                decayTco = exp(-4.95);
+            }
+            else if (curvatureType == ADSREnvelope::kLinearInDb)
+            {
+                attackTco = 0.99999;
+                decayTco = exp(-11.05);
+            }
+
+            MultiSegmentEnvelopeGenerator::SegmentDescriptor desc[] = {
+                { 0.0, 0.0, 0.0, -1 },                                      // kIdle: 0 forever
+                { 1.0, 0.0, 0.0, silenceSamples },                          // kSilence in 10 mSec
+                { 0.0, 1.0, attackTco, attackSamples },                     // kAttack
+                { 1.0, sustainFraction, decayTco, decaySamples },           // kDecay
+                { sustainFraction, sustainFraction, 0.0, -1 },              // kSustain
+                { 1.0, 0.0, decayTco, releaseSamples },                     // kRelease
+            };
+            segments[curvatureType].assign(desc, desc + sizeof(desc) / sizeof(desc[0]));
         }
-        else
-        {
-            envDesc.push_back({ 0.0, 1.0, 0.0, attackSamples });                        // kAttack
-            envDesc.push_back({ 1.0, sustainFraction, 0.0, decaySamples });             // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });           // kSustain
-            envDesc.push_back({ sustainFraction, 0.0, 0.0, releaseSamples });           // kRelease
-        }
-
-        env.reset(&envDesc);
     }
 
-    void ADSREnvelope::updateParams()
+
+    void ADSREnvelope::init(CurvatureType curvatureType)
     {
-        if (envDesc.size() < 6) return;
-        double sustainFraction = double(pParameters->sustainFraction);
-
-        envDesc[kAttack].lengthSamples = int(pParameters->attackSamples);
-        envDesc[kDecay].finalValue = sustainFraction;
-        envDesc[kDecay].lengthSamples = int(pParameters->decaySamples);
-        envDesc[kSustain].initialValue = envDesc[kSustain].finalValue = sustainFraction;
-        envDesc[kRelease].initialValue = sustainFraction;
-        envDesc[kRelease].lengthSamples = int(pParameters->releaseSamples);
+        curvature = curvatureType;
+        reset();
     }
 
     void ADSREnvelope::start()
@@ -99,13 +94,12 @@ namespace DunneCore
 
     void ADSREnvelope::release()
     {
-        envDesc[kRelease].initialValue = env.getValue(); //update release start value to current val of envelope
         env.advanceToSegment(kRelease);
     }
 
     void ADSREnvelope::reset()
     {
-        env.reset(&envDesc);
+        env.reset(&pParameters->segments[curvature]);
     }
 
 }
@@ -11,11 +11,17 @@ namespace DunneCore
         float attackSamples, decaySamples, releaseSamples;
         float sustainFraction;    // [0.0, 1.0]
 
+        // segments for each ADSREnvelope::CurvatureType, shared by all envelopes using these parameters
+        MultiSegmentEnvelopeGenerator::Descriptor segments[3];
+
         ADSREnvelopeParameters();
         void init(float newSampleRateHz, float attackSeconds, float decaySeconds, float susFraction, float releaseSeconds);
         void init(float attackSeconds, float decaySeconds, float susFraction, float releaseSeconds);
         void updateSampleRate(float newSampleRateHz);
 
+        // call after changing any of the values above, to bring segments up to date
+        void updateSegments();
+
         void setAttackDurationSeconds(float attackSeconds) { attackSamples = attackSeconds * sampleRateHz; }
         float getAttackDurationSeconds() { return attackSamples / sampleRateHz; }
         void setDecayDurationSeconds(float decaySeconds) { decaySamples = decaySeconds * sampleRateHz; }
@@ -26,7 +32,8 @@ namespace DunneCore
 
     struct ADSREnvelope
     {
-        ADSREnvelopeParameters* pParameters; // many ADSREnvelopes can share a common set of parameters
+        ADSREnvelopeParameters* pParameters; // many ADSREnvelopes can share a common set of parameters,
+                                             // including segments; each keeps only its own position
 
         enum EG_Segment
         {
@@ -46,7 +53,6 @@ namespace DunneCore
         };
 
         void init(CurvatureType curvatureType = kAnalogLike);
-        void updateParams();
 
         void start();       // called for note-on
         void restart();     // quickly dampen note then start again
@@ -68,9 +74,15 @@ namespace DunneCore
             return sample;
         }
 
+        // sampleCount values at once; stepsPerValue < 1 runs at a multiple of the parameters' rate
+        inline void getSamples(float *pOut, int sampleCount, double stepsPerValue = 1.0)
+        {
+            env.getSamples(pOut, sampleCount, stepsPerValue);
+        }
+
     protected:
         MultiSegmentEnvelopeGenerator env;
-        MultiSegmentEnvelopeGenerator::Descriptor envDesc;
+        CurvatureType curvature;
     };
 
 }
@@ -22,6 +22,7 @@ namespace DunneCore
         sustainFraction = susFraction;
         releaseHoldSamples = releaseHoldSeconds * sampleRateHz;
         releaseSamples = releaseSeconds * sampleRateHz;
+        updateSegments();
     }
 
     void AHDSHREnvelopeParameters::init(float newSampleRateHz, float attackSeconds, float holdSeconds, float decaySeconds,
@@ -40,71 +41,54 @@ namespace DunneCore
         decaySamples *= scaleFactor;
         releaseHoldSamples *= scaleFactor;
         releaseSamples *= scaleFactor;
+        updateSegments();
     }
 
-
-    void AHDSHREnvelope::init(CurvatureType curvatureType)
+    void AHDSHREnvelopeParameters::updateSegments()
     {
-        int silenceSamples = int(0.01 * pParameters->sampleRateHz);     // always 10 mSec
-        int attackSamples = int(pParameters->attackSamples);
-        int holdSamples = int(pParameters->holdSamples);
-        int decaySamples = int(pParameters->decaySamples);
-        double sustainFraction = double(pParameters->sustainFraction);
-        int releaseHoldSamples = int(pParameters->releaseHoldSamples);
-        int releaseSamples = int(pParameters->releaseSamples);
-
-        envDesc.clear();
-        envDesc.push_back({ 0.0, 0.0, 0.0, -1 });               // kIdle: 0 forever
-        envDesc.push_back({ 1.0, 0.0, 0.0, silenceSamples });   // kSilence in 10 mSec
-
-        if (curvatureType == kAnalogLike)
+        int silenceSamples = int(0.01 * sampleRateHz);     // always 10 mSec
+        int attackSamples = int(this->attackSamples);
+        int holdSamples = int(this->holdSamples);
+        int decaySamples = int(this->decaySamples);
+        double sustainFraction = double(this->sustainFraction);
+        int releaseHoldSamples = int(this->releaseHoldSamples);
+        int releaseSamples = int(this->releaseSamples);
+
+        // As in ADSREnvelopeParameters::updateSegments(): overwritten in place, and kSilence and
+        // kRelease start wherever the envelope is. kReleaseHold holds wherever it is.
+        for (int curvatureType = AHDSHREnvelope::kLinear; curvatureType <= AHDSHREnvelope::kLinearInDb; curvatureType++)
         {
-            envDesc.push_back({ 0.0, 1.0, exp(-1.5), attackSamples });                          // kAttack
-            envDesc.push_back({ 1.0, 1.0, 0.0, holdSamples });                                  // kHold
-            envDesc.push_back({ 1.0, sustainFraction, exp(-4.95), decaySamples });              // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });                   // kSustain
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, releaseHoldSamples });   // kReleaseHold
-            envDesc.push_back({ sustainFraction, 0.0, exp(-4.95), releaseSamples });            // kRelease
+            double attackTco = 0.0, decayTco = 0.0;
+            if (curvatureType == AHDSHREnvelope::kAnalogLike)
+            {
+                attackTco = exp(-1.5);
+                decayTco = exp(-4.95);
+            }
+            else if (curvatureType == AHDSHREnvelope::kLinearInDb)
+            {
+                attackTco = 0.99999;
+                decayTco = exp(-11.05);
+            }
+
+            MultiSegmentEnvelopeGenerator::SegmentDescriptor desc[] = {
+                { 0.0, 0.0, 0.0, -1 },                                          // kIdle: 0 forever
+                { 1.0, 0.0, 0.0, silenceSamples },                              // kSilence in 10 mSec
+                { 0.0, 1.0, attackTco, attackSamples },                         // kAttack
+                { 1.0, 1.0, 0.0, holdSamples },                                 // kHold
+                { 1.0, sustainFraction, decayTco, decaySamples },               // kDecay
+                { sustainFraction, sustainFraction, 0.0, -1 },                  // kSustain
+                { sustainFraction, sustainFraction, 0.0, releaseHoldSamples },  // kReleaseHold
+                { 1.0, 0.0, decayTco, releaseSamples },                         // kRelease
+            };
+            segments[curvatureType].assign(desc, desc + sizeof(desc) / sizeof(desc[0]));
         }
-        else if (curvatureType == kLinearInDb)
-        {
-            envDesc.push_back({ 0.0, 1.0, 0.99999, attackSamples });                            // kAttack
-            envDesc.push_back({ 1.0, 1.0, 0.0, holdSamples });                                  // kHold
-            envDesc.push_back({ 1.0, sustainFraction, exp(-11.05), decaySamples });             // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });                   // kSustain
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, releaseHoldSamples });   // kReleaseHold
-            envDesc.push_back({ sustainFraction, 0.0, exp(-11.05), releaseSamples });           // kRelease
-        }
-        else
-        {
-            envDesc.push_back({ 0.0, 1.0, 0.0, attackSamples });                                // kAttack
-            envDesc.push_back({ 1.0, 1.0, 0.0, holdSamples });                                  // kHold
-            envDesc.push_back({ 1.0, sustainFraction, 0.0, decaySamples });                     // kDecay
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, -1 });                   // kSustain
-            envDesc.push_back({ sustainFraction, sustainFraction, 0.0, releaseHoldSamples });   // kReleaseHold
-            envDesc.push_back({ sustainFraction, 0.0, 0.0, releaseSamples });                   // kRelease
-        }
-
-        env.reset(&envDesc);
     }
 
-    void AHDSHREnvelope::updateParams() __attribute__((no_sanitize("thread")))
+
+    void AHDSHREnvelope::init(CurvatureType curvatureType)
     {
-        if (envDesc.size() < 8) return;
-        double sustainFraction = double(pParameters->sustainFraction);
-
-        envDesc[kAttack].lengthSamples = int(pParameters->attackSamples);
-        envDesc[kHold].initialValue = 1.0;
-        envDesc[kHold].finalValue = 1.0;
-        envDesc[kHold].lengthSamples = int(pParameters->holdSamples);
-        envDesc[kDecay].finalValue = sustainFraction;
-        envDesc[kDecay].lengthSamples = int(pParameters->decaySamples);
-        envDesc[kSustain].initialValue = envDesc[kSustain].finalValue = sustainFraction;
-        envDesc[kReleaseHold].initialValue = sustainFraction;
-        envDesc[kReleaseHold].finalValue = sustainFraction;
-        envDesc[kReleaseHold].lengthSamples = int(pParameters->releaseHoldSamples);
-        envDesc[kRelease].initialValue = sustainFraction;
-        envDesc[kRelease].lengthSamples = int(pParameters->releaseSamples);
+        curvature = curvatureType;
+        reset();
     }
 
     void AHDSHREnvelope::start()
@@ -119,16 +103,12 @@ namespace DunneCore
 
     void AHDSHREnvelope::release()
     {
-        //update the 'release section' envelope values to be where the envelope currently is
-        envDesc[kReleaseHold].initialValue = env.getValue();
-        envDesc[kReleaseHold].finalValue = env.getValue();
-        envDesc[kRelease].initialValue = env.getValue();
         env.advanceToSegment(kReleaseHold);
     }
 
     void AHDSHREnvelope::reset()
     {
-        env.reset(&envDesc);
+        env.reset(&pParameters->segments[curvature]);
     }
 
 }
@@ -19,6 +19,9 @@ namespace DunneCore
         float attackSamples, holdSamples, decaySamples, releaseHoldSamples, releaseSamples;
         float sustainFraction;    // [0.0, 1.0]
 
+        // segments for each AHDSHREnvelope::CurvatureType, shared by all envelopes using these parameters
+        MultiSegmentEnvelopeGenerator::Descriptor segments[3];
+
         AHDSHREnvelopeParameters();
         void init(float newSampleRateHz, float attackSeconds, float holdSeconds, float decaySeconds, float susFraction,
                   float releaseHoldSeconds, float releaseSeconds);
@@ -26,6 +29,9 @@ namespace DunneCore
                   float releaseHoldSeconds, float releaseSeconds);
         void updateSampleRate(float newSampleRateHz);
 
+        // call after changing any of the values above, to bring segments up to date
+        void updateSegments();
+
         void setAttackDurationSeconds(float attackSeconds) { attackSamples = attackSeconds * sampleRateHz; }
         float getAttackDurationSeconds() { return attackSamples / sampleRateHz; }
         void setHoldDurationSeconds(float holdSeconds) { holdSamples = holdSeconds * sampleRateHz; }
@@ -40,7 +46,8 @@ namespace DunneCore
 
     struct AHDSHREnvelope
     {
-        AHDSHREnvelopeParameters* pParameters; // many ADSREnvelopes can share a common set of parameters
+        AHDSHREnvelopeParameters* pParameters; // many ADSREnvelopes can share a common set of parameters,
+                                               // including segments; each keeps only its own position
 
         enum EG_Segment
         {
@@ -62,7 +69,6 @@ namespace DunneCore
         };
 
         void init(CurvatureType curvatureType = kAnalogLike);
-        void updateParams();
 
         void start();       // called for note-on
         void restart();     // quickly dampen note then start again
@@ -86,9 +92,15 @@ namespace DunneCore
             return sample;
         }
 
+        // sampleCount values at once; stepsPerValue < 1 runs at a multiple of the parameters' rate
+        inline void getSamples(float *pOut, int sampleCount, double stepsPerValue = 1.0)
+        {
+            env.getSamples(pOut, sampleCount, stepsPerValue);
+        }
+
     protected:
         MultiSegmentEnvelopeGenerator env;
-        MultiSegmentEnvelopeGenerator::Descriptor envDesc;
+        CurvatureType curvature;
     };
 
 }
@@ -0,0 +1,47 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace DunneCore
+{
+
+    /// CounterRandom is a counter-based random number generator: value n of a stream is a hash of
+    /// (seed, stream, n), computed on its own, with nothing shared between streams. Give each voice
+    /// (or each oscillator of a voice) its own stream, and it draws the same numbers whatever order
+    /// voices are initialized or rendered in, and on whatever thread.
+    ///
+    /// The hash is SplitMix64: a Weyl sequence through a 64-bit finalizer. It passes BigCrush, is
+    /// a handful of integer instructions per value, and needs 16 bytes of state.
+    struct CounterRandom
+    {
+        uint64_t key;       // hash of seed and stream
+        uint64_t counter;   // index of the next value
+
+        CounterRandom(uint32_t seed = 0, uint32_t stream = 0) { setStream(seed, stream); }
+
+        /// select a stream, starting again from its first value
+        void setStream(uint32_t seed, uint32_t stream)
+        {
+            key = mix((uint64_t(seed) << 32) | stream);
+            counter = 0;
+        }
+
+        /// value n of the stream, regardless of the counter
+        uint32_t valueAt(uint64_t n) const
+        {
+            return uint32_t(mix(key + (n + 1) * 0x9E3779B97F4A7C15ull) >> 32);
+        }
+
+        uint32_t nextUInt32() { return valueAt(counter++); }
+
+        static uint64_t mix(uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+    };
+
+}
@@ -18,7 +18,7 @@ namespace DunneCore
         double sampleRateHz;
 
         // pointer to shared WaveStack
-        WaveStack *pWaveStack;
+        const WaveStack *pWaveStack;
 
         // per-phase variables
         static constexpr int phaseCount = 16;
@@ -26,12 +26,18 @@ namespace DunneCore
         // WaveStack octave used by this phase
         int octave[phaseCount];
 
-        // Fraction of the way through waveform
-        float phase[phaseCount];
+        // crossfade toward the next octave level, see WaveStack::octaveFor()
+        float octaveFade[phaseCount];
+
+        // Fraction of the way through waveform, as 32-bit fixed point (see WaveStack::interp())
+        uint32_t phase[phaseCount];
 
         // normalized frequency: cycles per sample
         float phaseDelta[phaseCount];
 
+        // fixed-point phase step per sample, including phaseDeltaMultiplier
+        uint32_t phaseIncrement[phaseCount];
+
         // relative level of each phase (fraction)
         float *level;
         float safetyLevels[phaseCount];
@@ -41,8 +47,9 @@ namespace DunneCore
         // phaseDelta multiplier for pitchbend, vibrato
         float phaseDeltaMultiplier;
 
-        void init(double sampleRate, WaveStack* pStack);
+        void init(double sampleRate, const WaveStack* pStack);
         void setFrequency(float frequency);
+        void setPhaseDeltaMultiplier(float multiplier);
 
         float getSample();
         void getSamples(float *pLeft, float *pRight, float gain);
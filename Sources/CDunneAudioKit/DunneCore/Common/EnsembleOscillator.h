@@ -4,7 +4,7 @@
 
 #include "FunctionTable.h"
 #include "WaveStack.h"
-#include <random>
+#include "CounterRandom.h"
 
 namespace DunneCore
 {
@@ -16,14 +16,14 @@ namespace DunneCore
     /// is a conventional, single-phase oscillator.
     struct EnsembleOscillator
     {
-        std::mt19937* gen;
-        std::uniform_real_distribution<float> dis{0.0f, 1.0f};
+        /// draws the random starting phases; set its stream before init()
+        CounterRandom random;
 
         /// current output sample rate
         double sampleRateHz;
 
         /// pointer to shared WaveStack
-        WaveStack *pWaveStack;
+        const WaveStack *pWaveStack;
 
         /// number of unison/ensemble phases
         int phaseCount;
@@ -38,11 +38,17 @@ namespace DunneCore
         /// WaveStack octave used by this phase
         int octave[maxPhases];
 
-        /// Fraction of the way through waveform
-        float phase[maxPhases];
+        /// crossfade toward the next octave level, see WaveStack::octaveFor()
+        float octaveFade[maxPhases];
+
+        /// Fraction of the way through waveform, as 32-bit fixed point (see WaveStack::interp())
+        uint32_t phase[maxPhases];
 
         /// normalized frequency: cycles per sample
         float phaseDelta[maxPhases];
+
+        /// fixed-point phase step per sample, including phaseDeltaMultiplier
+        uint32_t phaseIncrement[maxPhases];
         float leftGain[maxPhases];
         float rightGain[maxPhases];
 
@@ -51,14 +57,15 @@ namespace DunneCore
         /// phaseDelta multiplier for pitchbend, vibrato
         float phaseDeltaMultiplier;
 
-        EnsembleOscillator(std::mt19937* gen) : phaseCount(1), frequencySpread(0.0f), gen(gen) {}
-        void init(double sampleRate, WaveStack *pStack);
+        EnsembleOscillator() : phaseCount(1), frequencySpread(0.0f) {}
+        void init(double sampleRate, const WaveStack *pStack);
         void setPhases(int nPhases);
         void setFreqSpread(float fSpread) { frequencySpread = fSpread; }
 
         /// argument is a fraction: 0 = no spread, 1 = max spread
         void setPanSpread(float fSpread);
         void setFrequency(float frequency);
+        void setPhaseDeltaMultiplier(float multiplier);
 
         float getSample();
         void getSamples(float *pLeft, float *pRight, float gain);
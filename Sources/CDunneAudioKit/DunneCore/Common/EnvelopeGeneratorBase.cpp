@@ -1,6 +1,7 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "EnvelopeGeneratorBase.h"
+#include <algorithm>
 #include <cmath>
 
 namespace DunneCore
@@ -31,22 +32,94 @@ namespace DunneCore
             if (segmentLengthSamples == 0)
             {
                 coefficient = 0.0;
-                offset = target;
+                offset = asymptote = target;
             }
             else
             {
                 // Correction to Pirkle (who uses delta = 1.0 always)
                 // According to Redmon (who only discusses the delta = 1.0 case), delta should be defined thus
-                double delta = abs(targetValue - initialValue);
+                double delta = std::fabs(targetValue - initialValue);
                 coefficient = exp(-log((delta + tco) / tco) / segmentLengthSamples);
-                if (isRising)
-                    offset = (target + tco) * (1.0 - coefficient);
-                else
-                    offset = (target - tco) * (1.0 - coefficient);
+                asymptote = isRising ? target + tco : target - tco;
+                offset = asymptote * (1.0 - coefficient);
             }
         }
     }
 
+    int ExponentialSegmentGenerator::getSegmentSamples(float *pOut, int count, double stepsPerValue, bool& isSegmentDone)
+    {
+        // values to the end of the segment, counting the one which reaches target; untimed
+        // (sustain) segments, and exponential ones which can never arrive, go on indefinitely.
+        // Sloped segments are built to arrive on exactly their last step, so a tiny allowance
+        // keeps rounding from adding one more.
+        static const double allowance = 1e-6;
+        double end = HUGE_VAL;
+        double c = 1.0, d = 0.0, increment = 0.0;
+        if (isHorizontal)
+        {
+            if (segLength >= 0) end = std::ceil((segLength - tcount) / stepsPerValue);
+        }
+        else if (isLinear)
+        {
+            increment = coefficient * stepsPerValue;
+            end = increment == 0.0 ? 1.0 : std::ceil((target - output) / increment - allowance);
+        }
+        else
+        {
+            // output after k values is asymptote + d * c^k, which reaches target
+            // once c^k <= |target - asymptote| / |d|
+            c = std::pow(coefficient, stepsPerValue);
+            d = output - asymptote;
+            double ratio = std::fabs(target - asymptote) / std::fabs(d);
+            if (ratio >= 1.0 || c <= 0.0) end = 1.0;
+            else if (c < 1.0) end = std::ceil(std::log(ratio) / std::log(c) - allowance);
+        }
+        if (!(end >= 1.0)) end = 1.0;
+        isSegmentDone = end <= count;
+        int n = isSegmentDone ? int(end) : count;
+
+        // lo and hi bound the values, so rounding can never carry them past target
+        double lo = isRising ? output : target;
+        double hi = isRising ? target : output;
+        if (isHorizontal)
+        {
+            float value = float(target);
+            for (int i=0; i < n; i++) pOut[i] = value;
+            if (segLength >= 0) tcount += n * stepsPerValue;
+        }
+        else if (isLinear)
+        {
+            for (int i=0; i < n; i++)
+                pOut[i] = float(std::min(hi, std::max(lo, output + (i + 1) * increment)));
+            output = std::min(hi, std::max(lo, output + n * increment));
+        }
+        else
+        {
+            // four interleaved powers of c, so no value depends on the one before
+            double c2 = c * c, c4 = c2 * c2;
+            double p[4] = { c, c2, c2 * c, c4 };
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                for (int j=0; j < 4; j++)
+                {
+                    pOut[i + j] = float(std::min(hi, std::max(lo, asymptote + d * p[j])));
+                    p[j] *= c4;
+                }
+            }
+            for (int j=0; i < n; i++, j++)
+                pOut[i] = float(std::min(hi, std::max(lo, asymptote + d * p[j])));
+            output = std::min(hi, std::max(lo, asymptote + d * std::pow(c, n)));
+        }
+
+        if (isSegmentDone)
+        {
+            output = target;
+            pOut[n - 1] = float(target);
+        }
+        return n;
+    }
+
     void MultiSegmentEnvelopeGenerator::setupCurSeg()
     {
         SegmentDescriptor seg = (*segments)[curSegIndex];
@@ -64,18 +137,32 @@ namespace DunneCore
         ExponentialSegmentGenerator::reset(initValue, targetValue, seg.tco, seg.lengthSamples);
     }
 
-    void MultiSegmentEnvelopeGenerator::reset(Descriptor* pDesc, int initialSegmentIndex)
+    void MultiSegmentEnvelopeGenerator::reset(const Descriptor* pDesc, int initialSegmentIndex)
     {
         segments = pDesc;
         curSegIndex = initialSegmentIndex;
         setupCurSeg();
     }
 
+    bool MultiSegmentEnvelopeGenerator::getSamples(float *pOut, int count, double stepsPerValue)
+    {
+        bool isFinished = false;
+        while (count > 0)
+        {
+            bool isSegmentDone;
+            int n = getSegmentSamples(pOut, count, stepsPerValue, isSegmentDone);
+            pOut += n;
+            count -= n;
+            if (isSegmentDone && nextSegment()) isFinished = true;
+        }
+        return isFinished;
+    }
+
     void MultiSegmentEnvelopeGenerator::startAtSegment(int segIndex) //puts the envelope in a 'fresh' state, allows sudden jumps to first segment
     {
         curSegIndex = segIndex;
         if (skipEmptySegments()) {
-            SegmentDescriptor& seg = (*segments)[curSegIndex];
+            const SegmentDescriptor& seg = (*segments)[curSegIndex];
             setupCurSeg(seg.initialValue); // we are restarting, not advancing, so  always start from the first value we get to
         };
     }
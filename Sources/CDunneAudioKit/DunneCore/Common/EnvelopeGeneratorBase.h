@@ -25,6 +25,13 @@ namespace DunneCore
             return float(isHorizontal ? target : output);
         }
 
+        // Block equivalent of getSample(), for the current segment only: write up to count values to
+        // pOut, advancing stepsPerValue steps per value (e.g. 1/16 to evaluate a segment timed in
+        // 16-sample chunks at audio rate). Values come from the closed form offset + coef^n, so the
+        // loop has no per-value branches or dependency on the previous value. Returns the number of
+        // values written, and sets isSegmentDone if the last of them ended the segment.
+        int getSegmentSamples(float *pOut, int count, double stepsPerValue, bool& isSegmentDone);
+
         inline bool getSample(float& out)
         {
             if (isHorizontal)
@@ -48,9 +55,11 @@ namespace DunneCore
 
     protected:
         double output, target, offset, coefficient;
+        double asymptote;       // of exponential segments: output = asymptote + (output - asymptote) * coefficient
         bool isRising;
         bool isHorizontal;
-        int tcount, segLength;
+        double tcount;          // steps taken through a timed hold segment, not always whole
+        int segLength;
         bool isLinear;
     };
 
@@ -66,36 +75,53 @@ namespace DunneCore
         };
         typedef std::vector<SegmentDescriptor> Descriptor;
 
-        void reset(Descriptor* pDesc, int initialSegmentIndex = 0);
+        // The descriptor is only read, so many generators can share one (see ADSREnvelopeParameters).
+        // advanceToSegment() starts from wherever the envelope is, and a flat (hold) segment entered
+        // that way holds that value, so the segment after a hold also starts from the held value.
+        void reset(const Descriptor* pDesc, int initialSegmentIndex = 0);
         void advanceToSegment(int segIndex);
         void startAtSegment(int segIndex);
 
+        // returns true when the envelope has finished, and reset itself
         inline bool getSample(float& out)
         {            
-            if (ExponentialSegmentGenerator::getSample(out))
-            {
-                if (++curSegIndex >= int(segments->size()))
-                {
-                    reset(segments);
-                    return true;
-                }
-                else
-                {
-                    setupCurSeg();
-                }
-            }
+            if (ExponentialSegmentGenerator::getSample(out)) return nextSegment();
             return false;
         }
 
+        // Write count values to pOut, as count calls to getSample() would, but a segment at a time.
+        // stepsPerValue < 1 runs the envelope at a multiple of the rate its segments are timed for,
+        // e.g. 1.0 / CORESAMPLER_CHUNKSIZE for audio rate. Returns true if the envelope finished.
+        bool getSamples(float *pOut, int count, double stepsPerValue = 1.0);
+
         int getCurrentSegmentIndex() { return curSegIndex; }
 
     protected:
-        Descriptor* segments = nullptr;
+        const Descriptor* segments = nullptr;
         int curSegIndex;
 
         void setupCurSeg();
         void setupCurSeg(double initValue);
         bool skipEmptySegments();
+
+        // set up the segment after the one just finished; true if that was the last
+        inline bool nextSegment()
+        {
+            if (++curSegIndex >= int(segments->size()))
+            {
+                reset(segments);
+                return true;
+            }
+            else if (isHorizontal)
+            {
+                setupCurSeg(getValue());
+            }
+            else
+            {
+                setupCurSeg();
+            }
+            return false;
+        }
     };
 
 }
@@ -0,0 +1,119 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// FastMath provides approximations of the few transcendental functions used on the render thread,
+// mainly to turn semitones into frequency ratios and back, and cutoff frequencies into filter
+// gains. Each comes as a scalar inline function, and as a block version taking arrays, whose loop
+// has no branches or library calls, so the compiler can vectorize it (SSE2/AVX, NEON). Clang does
+// so at -O2; GCC needs -O3 and -fno-trapping-math before it will turn the selects into blends.
+//
+// Maximum errors, over the ranges given, include float rounding:
+//
+//   fastExp2(x)    relative 1.5e-7 (0.0003 cents), for -126 <= x <= 126
+//   fastLog2(x)    absolute 3e-7 octaves (0.0004 cents), for 2^-8 <= x <= 2^8, and to within
+//                  one float step of the result beyond that; x must be positive and normal
+//   fastSin(x)     absolute 5e-7 (-126 dB full scale), for |x| <= 64 pi
+//   fastTan(x)     relative 1e-5 for 0 <= x <= 1.3, 7e-4 (0.006 dB) at 0.495 pi
+//
+// Benchmarks/FastMathBenchmark.cpp times them against the standard library and checks these bounds,
+// as does Tests/DunneAudioKitTests/FastMathTests.swift.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace DunneCore
+{
+
+    namespace FastMathDetail
+    {
+        inline float floatFromBits(int32_t i) { float f; memcpy(&f, &i, sizeof(f)); return f; }
+        inline int32_t bitsFromFloat(float f) { int32_t i; memcpy(&i, &f, sizeof(i)); return i; }
+    }
+
+    /// 2^x. Rounds x to the nearest integer n, which goes straight into the exponent, and takes
+    /// 2^(x - n) from a degree-6 polynomial. x is clamped to [-126, 126]. Exact for integer x,
+    /// so a pitch offset of 0 or whole octaves gives a ratio of exactly 1 or a power of 2.
+    inline float fastExp2(float x)
+    {
+        x = x < -126.0f ? -126.0f : (x > 126.0f ? 126.0f : x);
+        // truncation of a positive value rounds it, without a call to floorf()
+        int32_t n = int32_t(x + 128.5f) - 128;
+        float f = x - float(n);
+        float p = 1.0f + f * (0.693147188f + f * (0.240226508f + f * (0.0555035711f
+                  + f * (0.00961808256f + f * (0.00133908634f + f * 0.000154531629f)))));
+        return p * FastMathDetail::floatFromBits((n + 127) << 23);
+    }
+
+    /// log2(x) for positive, normal x. Splits x into 2^e * m with m in [sqrt(1/2), sqrt(2)), and
+    /// takes log2(m) from the series in t = (m - 1) / (m + 1).
+    inline float fastLog2(float x)
+    {
+        int32_t bits = FastMathDetail::bitsFromFloat(x);
+        int32_t e = ((bits >> 23) & 0xff) - 127;
+        float m = FastMathDetail::floatFromBits((bits & 0x007fffff) | 0x3f800000);
+        int32_t isHigh = m > 1.41421356f;
+        m = isHigh ? 0.5f * m : m;
+        e += isHigh;
+        float t = (m - 1.0f) / (m + 1.0f);
+        float t2 = t * t;
+        return float(e) + t * (2.88539042f + t2 * (0.961588947f + t2 * 0.595759607f));
+    }
+
+    /// 2^(semitones / 12), the frequency ratio for a pitch offset
+    inline float fastSemitonesToRatio(float semitones)
+    {
+        return fastExp2(semitones * (1.0f / 12.0f));
+    }
+
+    /// 12 * log2(ratio), the pitch offset for a positive frequency ratio
+    inline float fastRatioToSemitones(float ratio)
+    {
+        return 12.0f * fastLog2(ratio);
+    }
+
+    /// sin(x). Reduces x to [-pi, pi] by the nearest multiple of 2 pi, folds that into
+    /// [-pi/2, pi/2], then uses an odd polynomial of degree 9.
+    inline float fastSin(float x)
+    {
+        float halfTurns = x * 0.159154943f;
+        float k = float(int32_t(halfTurns + (halfTurns < 0.0f ? -0.5f : 0.5f)));
+        // 2 pi in two parts, so the reduction stays exact for the larger k
+        float r = (x - k * 6.28125f) - k * 0.00193530717f;
+        r = r > 1.57079633f ? 3.14159265f - r : r;
+        r = r < -1.57079633f ? -3.14159265f - r : r;
+        float r2 = r * r;
+        return r * (0.999999996f + r2 * (-0.166666579f + r2 * (0.00833305017f
+               + r2 * (-0.000198090174f + r2 * 2.60510763e-6f))));
+    }
+
+    /// tan(x) for 0 <= x <= 0.495 * pi, by a [5/4] Pade approximant. Used for TPT filter gains.
+    inline float fastTan(float x)
+    {
+        float x2 = x * x;
+        return x * (945.0f + x2 * (x2 - 105.0f)) / (945.0f + x2 * (15.0f * x2 - 420.0f));
+    }
+
+    // Block versions: pOut[i] = f(pIn[i]) for count values. pIn may equal pOut.
+
+    inline void fastExp2(const float *pIn, float *pOut, int count)
+    {
+        for (int i=0; i < count; i++) pOut[i] = fastExp2(pIn[i]);
+    }
+
+    inline void fastLog2(const float *pIn, float *pOut, int count)
+    {
+        for (int i=0; i < count; i++) pOut[i] = fastLog2(pIn[i]);
+    }
+
+    inline void fastSin(const float *pIn, float *pOut, int count)
+    {
+        for (int i=0; i < count; i++) pOut[i] = fastSin(pIn[i]);
+    }
+
+    inline void fastTan(const float *pIn, float *pOut, int count)
+    {
+        for (int i=0; i < count; i++) pOut[i] = fastTan(pIn[i]);
+    }
+
+}
@@ -0,0 +1,132 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "ForkJoinPool.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace DunneCore
+{
+
+    namespace
+    {
+        // Spins per wait before giving up the core: roughly tens of microseconds, a small part
+        // of a 16-sample chunk, so workers stay awake from one chunk to the next while playing.
+        constexpr int spinCount = 4096;
+
+        inline void cpuPause()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+
+        void requestRealTimePriority(std::thread& thread)
+        {
+#if defined(__APPLE__) || defined(__linux__)
+            // best effort: without the privilege, the worker simply keeps normal priority
+            sched_param parameters;
+            parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+            pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &parameters);
+#else
+            (void)thread;
+#endif
+        }
+    }
+
+    void ForkJoinPool::setThreadCount(int threadCount)
+    {
+        // more threads than cores would only take turns, spinning on each other
+        int hardwareThreads = int(std::thread::hardware_concurrency());
+        if (hardwareThreads > 0 && threadCount > hardwareThreads) threadCount = hardwareThreads;
+        if (threadCount < 1) threadCount = 1;
+        if (threadCount == getThreadCount()) return;
+
+        // stop all workers, then start afresh, so each keeps a fixed taskIndex
+        if (!workers.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isStopping = true;
+            }
+            wakeup.notify_all();
+            for (auto& worker : workers) worker.join();
+            workers.clear();
+            isStopping = false;
+        }
+
+        for (int i=1; i < threadCount; i++)
+        {
+            workers.emplace_back(&ForkJoinPool::workerLoop, this, i, generation.load());
+            requestRealTimePriority(workers.back());
+        }
+    }
+
+    void ForkJoinPool::run(Task task, void *context)
+    {
+        int taskCount = getThreadCount();
+        if (taskCount == 1)
+        {
+            task(context, 0, 1);
+            return;
+        }
+
+        currentTask = task;
+        currentContext = context;
+        currentTaskCount = taskCount;
+        pendingCount.store(taskCount - 1);
+        generation.fetch_add(1);    // publishes the task; workers which see it will run it
+
+        // A worker going to sleep counts itself before its last look at generation, so one that
+        // missed the new value is counted here, and waits on the mutex until it can be woken.
+        if (sleepingCount.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeup.notify_all();
+        }
+
+        task(context, 0, taskCount);
+
+        for (int spins=0; pendingCount.load(std::memory_order_acquire) > 0; spins++)
+        {
+            if (spins < spinCount) cpuPause();
+            else std::this_thread::yield();
+        }
+    }
+
+    // seenGeneration is passed in by setThreadCount(), so a run() which starts before this thread
+    // does is not missed
+    void ForkJoinPool::workerLoop(int taskIndex, unsigned seenGeneration)
+    {
+        while (true)
+        {
+            for (int spins=0; spins < spinCount; spins++)
+            {
+                if (generation.load(std::memory_order_acquire) != seenGeneration) break;
+                cpuPause();
+            }
+
+            if (generation.load() == seenGeneration)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                sleepingCount.fetch_add(1);
+                wakeup.wait(lock, [&] { return isStopping.load() || generation.load() != seenGeneration; });
+                sleepingCount.fetch_sub(1);
+            }
+            if (isStopping.load()) return;
+
+            seenGeneration = generation.load();
+            currentTask(currentContext, taskIndex, currentTaskCount);
+            pendingCount.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+}
@@ -0,0 +1,57 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DunneCore
+{
+
+    /// ForkJoinPool runs one task on the calling thread and on a set of pre-spawned worker threads
+    /// at once, and returns when every one of them has finished: fork-join, for splitting the work
+    /// of one render chunk across cores.
+    ///
+    /// run() itself neither allocates nor blocks on a lock while workers are awake. Between runs a
+    /// worker spins briefly, then sleeps; waking a sleeping worker costs run() one notify. Workers
+    /// ask for real-time scheduling where the platform allows it.
+    struct ForkJoinPool
+    {
+        /// called as task(context, taskIndex, taskCount), for each taskIndex in [0, taskCount)
+        typedef void (*Task)(void *context, int taskIndex, int taskCount);
+
+        ForkJoinPool() {}
+        ~ForkJoinPool() { setThreadCount(1); }
+
+        /// Start or stop workers, so run() uses threadCount threads in all, counting the caller, but
+        /// no more than the hardware has. This waits for threads to start or finish, so never call
+        /// it during run(), or on the audio thread.
+        void setThreadCount(int threadCount);
+        int getThreadCount() const { return 1 + int(workers.size()); }
+
+        /// Call task on every thread, with taskIndex 0 on the calling thread, and return once all
+        /// calls have returned. Which taskIndex runs on which worker never changes.
+        void run(Task task, void *context);
+
+    private:
+        std::vector<std::thread> workers;
+
+        Task currentTask = nullptr;
+        void *currentContext = nullptr;
+        int currentTaskCount = 1;
+
+        std::atomic<unsigned> generation{0};    // incremented by each run()
+        std::atomic<int> pendingCount{0};       // workers still running the current task
+        std::atomic<int> sleepingCount{0};      // workers waiting on wakeup
+        std::atomic<bool> isStopping{false};
+
+        std::mutex mutex;
+        std::condition_variable wakeup;
+
+        void workerLoop(int taskIndex, unsigned seenGeneration);
+    };
+
+}
@@ -1,6 +1,7 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "FunctionTable.h"
+#include "LookupTables.h"
 #ifndef _USE_MATH_DEFINES
   #define _USE_MATH_DEFINES
 #endif
@@ -53,8 +54,18 @@ namespace DunneCore
         if (waveTable.empty()) init();
 
         auto nTableSize = waveTable.size();
-        for (int i=0; i < nTableSize; i++)
-            waveTable[i] = (float)(amplitude * sin(double(i)/nTableSize * 2.0 * M_PI));
+        if (nTableSize <= sineTableSize && sineTableSize % nTableSize == 0)
+        {
+            // every (sineTableSize / nTableSize)th value of sineTable is exactly what sin() gives
+            auto stride = sineTableSize / nTableSize;
+            for (int i=0; i < nTableSize; i++)
+                waveTable[i] = amplitude * sineTable[int(i * stride)];
+        }
+        else
+        {
+            for (int i=0; i < nTableSize; i++)
+                waveTable[i] = (float)(amplitude * sin(double(i)/nTableSize * 2.0 * M_PI));
+        }
     }
 
     // A variation of sinusoid() which adds a tiny bit of 2nd harmonic, producing a tone closer to
@@ -137,8 +148,8 @@ namespace DunneCore
     {
         waveTable.init(tableLength);
         sampleRateHz = sampleRate;
-        phase = 0.0f;
-        phaseDelta = (float)(frequency / sampleRate);
+        phase = 0.0;
+        phaseDelta = frequency / sampleRate;
     }
     
     void FunctionTableOscillator::deinit()
@@ -148,7 +159,16 @@ namespace DunneCore
     
     void FunctionTableOscillator::setFrequency(float frequency)
     {
-        phaseDelta = (float)(frequency / sampleRateHz);
+        phaseDelta = frequency / sampleRateHz;
+    }
+
+    void SharedFunctionTableOscillator::init(const float *pSharedTable, int sharedTableSize, double sampleRate, float frequency)
+    {
+        pTable = pSharedTable;
+        tableSize = sharedTableSize;
+        sampleRateHz = sampleRate;
+        phase = 0.0f;
+        phaseDelta = (float)(frequency / sampleRate);
     }
 
     // Initialize WaveShaper's lookup table to an identity
@@ -8,6 +8,23 @@ namespace DunneCore
 {
     #define DEFAULT_WAVETABLE_SIZE 256
 
+    /// Linear interpolation in a cyclic table of tableSize values, at normalized phase [0.0, 1.0)
+    /// (or any phase, which wraps around)
+    inline float interpCyclic(const float *table, int tableSize, float phase)
+    {
+        while (phase < 0) phase += 1.0;
+        while (phase >= 1.0) phase -= 1.0f;
+
+        float readIndex = phase * tableSize;
+        int ri = int(readIndex);
+        float f = readIndex - ri;
+        int rj = ri + 1; if (rj >= tableSize) rj -= tableSize;
+
+        float si = table[ri];
+        float sj = table[rj];
+        return (float)((1.0 - f) * si + f * sj);
+    }
+
     /// FunctionTable represents a simple one-dimensional table of float values,
     /// addressable by a normalized fractional index, [0.0, 1.0), with or without wraparound.
     /// Linear interpolation is used to interpolate values between available samples.
@@ -35,22 +52,10 @@ namespace DunneCore
         void sinusoid(float amplitude=1.0f);
         void hammond(float amplitude=1.0f);
         void square(float amplitude=1.0f, float dutyCycle=0.5f);
-        
-        inline float interp_cyclic(float phase)
-        {
-            while (phase < 0) phase += 1.0;
-            while (phase >= 1.0) phase -= 1.0f;
 
-            auto nTableSize = waveTable.size();
-            
-            float readIndex = phase * nTableSize;
-            int ri = int(readIndex);
-            float f = readIndex - ri;
-            int rj = ri + 1; if (rj >= nTableSize) rj -= nTableSize;
-            
-            float si = waveTable[ri];
-            float sj = waveTable[rj];
-            return (float)((1.0 - f) * si + f * sj);
+        inline float interp_cyclic(float phase) const
+        {
+            return interpCyclic(waveTable.data(), int(waveTable.size()), phase);
         }
         
         // functions for use by class WaveShaper (see comments in .cpp file)
@@ -58,7 +63,7 @@ namespace DunneCore
         void exponentialCurve(float left, float right);
         void powerCurve(float exponent);
         
-        inline float interp_bounded(float phase)
+        inline float interp_bounded(float phase) const
         {
             if (phase < 0) return waveTable.front();
             if (phase >= 1.0) return waveTable.back();
@@ -84,8 +89,8 @@ namespace DunneCore
     struct FunctionTableOscillator
     {
         double sampleRateHz;
-        float phase;
-        float phaseDelta;   // normalized frequency: cycles per sample
+        double phase;       // in double, so that a slow LFO keeps its rate, rather than drifting
+        double phaseDelta;  // normalized frequency: cycles per sample
         FunctionTable waveTable;
         
         ~FunctionTableOscillator() { deinit(); }
@@ -97,9 +102,9 @@ namespace DunneCore
         // For typical LFO applications, we simply get one sample at a time.
         inline float getSample()
         {
-            float sample = waveTable.interp_cyclic(phase);
+            float sample = waveTable.interp_cyclic(float(phase));
             phase += phaseDelta;
-            if (phase >= 1.0f) phase -= 1.0f;
+            if (phase >= 1.0) phase -= 1.0;
             return sample;
         }
 
@@ -108,8 +113,55 @@ namespace DunneCore
         // "quadrature" sample which is 90 degrees out-of-phase with the first one.
         inline void getSamples(float *pInPhase, float *pQuadrature)
         {
-            *pInPhase = waveTable.interp_cyclic(phase);
-            *pQuadrature = waveTable.interp_cyclic(phase + 0.25f);
+            *pInPhase = waveTable.interp_cyclic(float(phase));
+            *pQuadrature = waveTable.interp_cyclic(float(phase + 0.25));
+            phase += phaseDelta;
+            if (phase >= 1.0) phase -= 1.0;
+        }
+
+        // For an ensemble, count such pairs, their phases spread evenly over the cycle: pair k is
+        // what getSamples() above would return k/count of a cycle later.
+        inline void getSamples(float *pInPhase, float *pQuadrature, int count)
+        {
+            for (int k=0; k < count; k++)
+            {
+                double tapPhase = phase + double(k) / count;
+                pInPhase[k] = waveTable.interp_cyclic(float(tapPhase));
+                pQuadrature[k] = waveTable.interp_cyclic(float(tapPhase + 0.25));
+            }
+            phase += phaseDelta;
+            if (phase >= 1.0) phase -= 1.0;
+        }
+    };
+    
+    /// SharedFunctionTableOscillator is a FunctionTableOscillator which reads a table owned elsewhere,
+    /// so that any number of them (e.g. one per voice) can share one table, each keeping only its
+    /// own phase. The vibrato LFOs read sineTable (see LookupTables.h), which needs no setup at all.
+    struct SharedFunctionTableOscillator
+    {
+        const float *pTable;
+        int tableSize;
+        double sampleRateHz;
+        float phase;
+        float phaseDelta;   // normalized frequency: cycles per sample
+
+        void init(const float *pSharedTable, int sharedTableSize, double sampleRate, float frequency);
+
+        inline void setFrequency(float frequency)
+        {
+            phaseDelta = (float)(frequency / sampleRateHz);
+        }
+
+        inline float getSample()
+        {
+            float sample = interpCyclic(pTable, tableSize, phase);
+            advance();
+            return sample;
+        }
+
+        // move on one sample without reading the table, e.g. while the LFO's depth is zero
+        inline void advance()
+        {
             phase += phaseDelta;
             if (phase >= 1.0f) phase -= 1.0f;
         }
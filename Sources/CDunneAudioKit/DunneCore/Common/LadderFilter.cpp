@@ -0,0 +1,98 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// LadderFilter implements a 4-pole TPT ladder low-pass filter with smoothly adjustable
+// cutoff frequency and resonance.
+
+#include "LadderFilter.h"
+
+namespace DunneCore
+{
+    static const float kMinResLinear = 0.1f;
+    static const float kMaxFeedback = 4.0f;     // self-oscillation
+
+    LadderFilter::LadderFilter()
+    {
+        init(44100.0);
+    }
+
+    void LadderFilter::init(double sampleRateHz)
+    {
+        this->sampleRateHz = sampleRateHz;
+        g = k = gTarget = kTarget = 0.0f;
+        for (int p=0; p < poles; p++)
+            s[p][0] = s[p][1] = 0.0f;
+        mLastCutoffHz = mLastResLinear = -1.0;  // force recalc of coefficients
+    }
+
+    void LadderFilter::setParameters(double newCutoffHz, double newResLinear)
+    {
+        if (newCutoffHz == mLastCutoffHz && newResLinear == mLastResLinear) return;
+
+        gTarget = StateVariableFilter::gainFor(sampleRateHz, newCutoffHz);
+        kTarget = feedbackFor(newResLinear);
+
+        // no ramp from the values left by init()
+        if (mLastCutoffHz < 0.0)
+        {
+            g = gTarget;
+            k = kTarget;
+        }
+        mLastCutoffHz = newCutoffHz;
+        mLastResLinear = newResLinear;
+    }
+
+    float LadderFilter::feedbackFor(double resLinear)
+    {
+        if (resLinear < kMinResLinear) resLinear = kMinResLinear;
+        if (resLinear > 1.0) resLinear = 1.0;
+        return float(kMaxFeedback * (1.0 - resLinear));
+    }
+
+    void LadderFilter::process(float *pLeft, float *pRight, int sampleCount)
+    {
+        processChannels<2>(pLeft, pRight, sampleCount);
+    }
+
+    void LadderFilter::processMono(float *pMono, int sampleCount)
+    {
+        processChannels<1>(pMono, nullptr, sampleCount);
+        for (int p=0; p < poles; p++) s[p][1] = s[p][0];
+    }
+
+    template<int channelCount>
+    void LadderFilter::processChannels(float *pLeft, float *pRight, int sampleCount)
+    {
+        if (sampleCount <= 0) return;
+
+        // local copies, so the compiler can keep the whole recursion in registers
+        float sg = g, sk = k;
+        float dg = (gTarget - g) / sampleCount, dk = (kTarget - k) / sampleCount;
+        float s1[2] = { s[0][0], s[0][1] }, s2[2] = { s[1][0], s[1][1] };
+        float s3[2] = { s[2][0], s[2][1] }, s4[2] = { s[3][0], s[3][1] };
+
+        for (int i=0; i < sampleCount; i++)
+        {
+            sg += dg;
+            sk += dk;
+            float G, beta, fb;
+            coefficients(sg, sk, G, beta, fb);
+
+            float x[2] = { pLeft[i], channelCount == 2 ? pRight[i] : 0.0f };
+            for (int ch=0; ch < channelCount; ch++)
+                x[ch] = tick(x[ch], G, beta, sk, fb, s1[ch], s2[ch], s3[ch], s4[ch]);
+            pLeft[i] = x[0];
+            if (channelCount == 2) pRight[i] = x[1];
+        }
+
+        g = gTarget;
+        k = kTarget;
+        for (int ch=0; ch < channelCount; ch++)
+        {
+            s[0][ch] = s1[ch];
+            s[1][ch] = s2[ch];
+            s[2][ch] = s3[ch];
+            s[3][ch] = s4[ch];
+        }
+    }
+
+}
@@ -0,0 +1,86 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// LadderFilter implements a 4-pole "ladder" low-pass filter in topology-preserving transform
+// form: four trapezoidal one-pole stages, with the resonance feedback loop solved exactly, so
+// (like StateVariableFilter) it stays well-behaved while the cutoff moves every sample. It is
+// linear (no saturation), and the input is scaled up with the feedback, so the passband level
+// does not drop as resonance rises.
+//
+// Resonance uses the same linear scale as ResonantLowPassFilter, 10.0 (-20 dB) to 0.1 (+20 dB);
+// from 0 dB down, the filter is a plain 4-pole low-pass, and at 0.1 it is close to self-oscillation.
+
+#pragma once
+
+#include "StateVariableFilter.h"
+
+namespace DunneCore
+{
+
+    // A stereo ladder filter. setParameters() sets new targets, which the next process() ramps
+    // to sample by sample, as LinearRamper does.
+    struct LadderFilter
+    {
+        static constexpr int poles = 4;
+
+        // integrator gain g = tan(pi * cutoff / sampleRate), and feedback k: current values, and targets
+        float g, k, gTarget, kTarget;
+
+        // one-pole state, [pole][channel]
+        float s[poles][2];
+
+        double sampleRateHz, mLastCutoffHz, mLastResLinear;
+
+        LadderFilter();
+
+        void init(double sampleRateHz);
+        void updateSampleRate(double sampleRate) { sampleRateHz = sampleRate; }
+
+        void setParameters(double newCutoffHz, double newResLinear);
+
+        // filter sampleCount samples of pLeft and pRight in place, ramping the coefficients from
+        // their current values to their targets across the block
+        void process(float *pLeft, float *pRight, int sampleCount);
+
+        // process() of one channel only, for a source with identical left and right: filters pMono
+        // as the left channel, then copies its state to the right
+        void processMono(float *pMono, int sampleCount);
+
+        // Feedback for resLinear, from 0 (resLinear >= 1) up to 3.6 (resLinear = 0.1)
+        static float feedbackFor(double resLinear);
+
+        // Coefficients of one sample, for the current g and k: the one-pole gain G = g / (1 + g),
+        // the weight beta = 1 / (1 + g) of the one-pole states, and fb = 1 / (1 + k * G^4), which
+        // solves the feedback loop. With p = 1 + g and d = p^4 + k * g^4, beta = d / (p * d) and
+        // fb = p^5 / (p * d), so one division serves for both.
+        static inline void coefficients(float g, float k, float& G, float& beta, float& fb)
+        {
+            float p = 1.0f + g;
+            float p2 = p * p, g2 = g * g;
+            float d = p2 * p2 + k * (g2 * g2);
+            float r = 1.0f / (p * d);
+            beta = d * r;
+            G = g * beta;
+            fb = (p2 * p2) * p * r;
+        }
+
+        // One sample through all four poles
+        static inline float tick(float x, float G, float beta, float k, float fb,
+                                 float& s1, float& s2, float& s3, float& s4)
+        {
+            // each pole's output is G times its input plus beta times its state, so the ladder's
+            // output is G^4 times the ladder input u, plus S; solve the feedback loop for u
+            float S = beta * (s4 + G * (s3 + G * (s2 + G * s1)));
+            float u = ((1.0f + k) * x - k * S) * fb;
+
+            float v = G * (u - s1); float y = v + s1; s1 = y + v;
+            v = G * (y - s2); y = v + s2; s2 = y + v;
+            v = G * (y - s3); y = v + s3; s3 = y + v;
+            v = G * (y - s4); y = v + s4; s4 = y + v;
+            return y;
+        }
+
+    private:
+        template<int channelCount> void processChannels(float *pLeft, float *pRight, int sampleCount);
+    };
+
+}
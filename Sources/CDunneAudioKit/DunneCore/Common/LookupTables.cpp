@@ -0,0 +1,96 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// The tables are generated by constexpr code, so a compiler which could not evaluate them at
+// compile time would fail to build rather than quietly compute them at startup. The generators
+// work in double precision to well under a float step, so every entry rounds to the same float as
+// the libm expressions they replace (checked by Benchmarks/LookupTablesBenchmark.cpp).
+
+#include "LookupTables.h"
+
+namespace DunneCore
+{
+
+    namespace
+    {
+        constexpr double pi = 3.14159265358979323846;
+
+        // pi/2 in three parts; the first two have short mantissas, so multiples of them are exact
+        constexpr double halfPi1 = 1.5707963267341256;
+        constexpr double halfPi2 = 6.077100506303966e-11;
+        constexpr double halfPi3 = 2.0222662487959506e-21;
+
+        // Taylor series of sin(x) and cos(x), to double precision for |x| <= pi/4
+        constexpr double sinSeries(double x)
+        {
+            double x2 = x * x, term = x, sum = x;
+            for (int n=1; n < 12; n++)
+            {
+                term *= -x2 / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double cosSeries(double x)
+        {
+            double x2 = x * x, term = 1.0, sum = 1.0;
+            for (int n=1; n < 12; n++)
+            {
+                term *= -x2 / ((2 * n - 1) * (2 * n));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // sin(x) for 0 <= x < 2 pi, reduced by the nearest multiple of pi/2
+        constexpr double sine(double x)
+        {
+            int quadrant = int(x / (0.5 * pi) + 0.5);
+            double r = ((x - quadrant * halfPi1) - quadrant * halfPi2) - quadrant * halfPi3;
+            switch (quadrant & 3)
+            {
+                case 0: return sinSeries(r);
+                case 1: return cosSeries(r);
+                case 2: return -sinSeries(r);
+                default: return -cosSeries(r);
+            }
+        }
+
+        // 2^x, from the integer part and exp(f ln 2) for the fraction f in [0, 1)
+        constexpr double exp2(double x)
+        {
+            int n = int(x);
+            if (x < n) n--;
+            double f = (x - n) * 0.69314718055994530942;
+            double term = 1.0, sum = 1.0;
+            for (int k=1; k < 24; k++)
+            {
+                term *= f / k;
+                sum += term;
+            }
+            for (; n > 0; n--) sum *= 2.0;
+            for (; n < 0; n++) sum *= 0.5;
+            return sum;
+        }
+
+        constexpr ConstantTable<sineTableSize> makeSineTable()
+        {
+            ConstantTable<sineTableSize> table {};
+            for (int i=0; i < sineTableSize; i++)
+                table.values[i] = float(sine(double(i) / sineTableSize * 2.0 * pi));
+            return table;
+        }
+
+        constexpr ConstantTable<128> makeNoteFrequencyTable()
+        {
+            ConstantTable<128> table {};
+            for (int i=0; i < 128; i++)
+                table.values[i] = 440.0f * float(exp2((i - 69.0f) / 12.0f));
+            return table;
+        }
+    }
+
+    constexpr ConstantTable<sineTableSize> sineTable = makeSineTable();
+    constexpr ConstantTable<128> noteFrequencyTable = makeNoteFrequencyTable();
+
+}
@@ -0,0 +1,31 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// LookupTables holds tables which are computed entirely at compile time, by constexpr functions
+// (see LookupTables.cpp), so they sit in read-only memory, need no initialization at run time,
+// and are safe to read from any thread at any time, even during static initialization.
+
+#pragma once
+
+namespace DunneCore
+{
+
+    /// N float values, generated at compile time
+    template<int N>
+    struct ConstantTable
+    {
+        static constexpr int size = N;
+        float values[N];
+
+        constexpr float operator[](int i) const { return values[i]; }
+    };
+
+    /// One cycle of a sine wave, sin(2 pi i / sineTableSize), bit-for-bit the same values as
+    /// FunctionTable::sinusoid(), which copies from it. Read by ResonantLowPassFilter, and by the
+    /// vibrato LFOs (see SharedFunctionTableOscillator).
+    constexpr int sineTableSize = 2048;
+    extern const ConstantTable<sineTableSize> sineTable;
+
+    /// Frequency in Hz of each MIDI note number, in equal temperament with note 69 (A4) at 440 Hz
+    extern const ConstantTable<128> noteFrequencyTable;
+
+}
@@ -0,0 +1,50 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "ModulationMatrix.h"
+
+namespace DunneCore
+{
+
+    void ModulationMatrix::setDefaultRoutes()
+    {
+        clearRoutes();
+        addRoute(kVelocitySource, kAmpDestination, 1.0f);
+        addRoute(kAmpEGSource, kAmpDestination, 1.0f);
+        addRoute(kFilterEGSource, kCutoffDestination, 1.0f);
+    }
+
+    void ModulationMatrix::clearRoutes()
+    {
+        routeCount = 0;
+        compile();
+    }
+
+    bool ModulationMatrix::addRoute(int source, int destination, float amount)
+    {
+        if (routeCount >= maxRoutes) return false;
+        if (source < 0 || source >= kModulationSourceCount) return false;
+        if (destination < 0 || destination >= kModulationDestinationCount) return false;
+
+        routes[routeCount++] = { ModulationSource(source), ModulationDestination(destination), amount };
+        compile();
+        return true;
+    }
+
+    void ModulationMatrix::compile()
+    {
+        int count = 0;
+        usedSources = 0;
+        for (int d=0; d < kModulationDestinationCount; d++)
+        {
+            first[d] = count;
+            for (int r=0; r < routeCount; r++)
+            {
+                if (routes[r].destination != d) continue;
+                operations[count++] = { routes[r].source, routes[r].amount };
+                usedSources |= 1u << routes[r].source;
+            }
+        }
+        first[kModulationDestinationCount] = count;
+    }
+
+}
@@ -0,0 +1,78 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+namespace DunneCore
+{
+
+    /// what a SynthVoice can be modulated by, each read once per chunk
+    enum ModulationSource
+    {
+        kAmpEGSource,           // 0 to 1
+        kFilterEGSource,        // 0 to 1
+        kPumpEGSource,          // the multi-segment envelope, 0 to 1
+        kVibratoLFOSource,      // the synth's shared vibrato LFO, -1 to 1
+        kVoiceLFOSource,        // a sine LFO of the voice's own, restarted with each note, -1 to 1
+        kVelocitySource,        // 0 to 1
+        kModulationSourceCount
+    };
+
+    /// what the sources of a SynthVoice can modulate
+    enum ModulationDestination
+    {
+        kCutoffDestination,     // note frequency * (1 + cutoffMultiple + cutoffStrength * sum)
+        kPitchDestination,      // semitones, sum, on top of the synth's pitch offset and vibrato
+        kAmpDestination,        // masterVolume * product of ((1 - amount) + amount * source)
+        kModulationDestinationCount
+    };
+
+    /// ModulationMatrix holds a synth's modulation routes, each taking a source to a destination by
+    /// some amount, and compiles them whenever they change into a flat list of operations, grouped
+    /// by destination, which each voice runs every chunk. A source no route reads costs a voice no
+    /// routing work; envelopes and LFOs still advance, so they are in step if routed mid-note.
+    ///
+    /// The default routes are what the synth always did: velocity and amp EG to amp, by 1 each, and
+    /// filter EG to cutoff, by 1. The amp EG still decides when a voice ends, routed or not.
+    struct ModulationMatrix
+    {
+        static const int maxRoutes = 16;
+
+        struct Operation
+        {
+            ModulationSource source;
+            float amount;
+        };
+
+        ModulationMatrix() { setDefaultRoutes(); }
+
+        void setDefaultRoutes();
+        void clearRoutes();
+
+        /// returns false, changing nothing, if all maxRoutes are in use or an argument is out of range
+        bool addRoute(int source, int destination, float amount);
+
+        bool isUsed(ModulationSource source) const { return (usedSources & (1u << source)) != 0; }
+
+        /// the operations of one destination, in the order their routes were added
+        const Operation *begin(ModulationDestination destination) const { return &operations[first[destination]]; }
+        const Operation *end(ModulationDestination destination) const { return &operations[first[destination + 1]]; }
+
+    private:
+        struct Route
+        {
+            ModulationSource source;
+            ModulationDestination destination;
+            float amount;
+        };
+        Route routes[maxRoutes];
+        int routeCount = 0;
+
+        // compiled by compile(): operations of destination d are [first[d], first[d + 1])
+        Operation operations[maxRoutes];
+        int first[kModulationDestinationCount + 1];
+        unsigned usedSources = 0;
+
+        void compile();
+    };
+
+}
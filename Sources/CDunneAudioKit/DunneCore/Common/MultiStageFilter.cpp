@@ -0,0 +1,120 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// MultiStageFilter implements a simple digital low-pass filter with dynamically
+// adjustable cutoff frequency and resonance.
+
+#include "MultiStageFilter.h"
+
+namespace DunneCore
+{
+    MultiStageFilter::MultiStageFilter()
+    {
+        init(44100.0);
+        stages = 1;
+    }
+    
+    void MultiStageFilter::init(double sampleRateHz)
+    {
+        this->sampleRateHz = sampleRateHz;
+        g = e1 = e2 = gTarget = e1Target = e2Target = 0.0f;
+        for (int s=0; s < maxStages; s++)
+            for (int ch=0; ch < 2; ch++)
+                x1[s][ch] = x2[s][ch] = y1[s][ch] = y2[s][ch] = 0.0f;
+        mLastCutoffHz = mLastResLinear = -1.0;  // force recalc of coefficients
+    }
+
+    void MultiStageFilter::setStages(int nStages)
+    {
+        if (nStages < 0) nStages = 0;
+        if (nStages > maxStages) nStages = maxStages;
+        stages = nStages;
+    }
+    
+    void MultiStageFilter::setParameters(double newCutoffHz, double newResLinear)
+    {
+        // only calculate the filter coefficients if the parameters have changed from last time
+        if (newCutoffHz == mLastCutoffHz && newResLinear == mLastResLinear) return;
+
+        ResonantLowPassFilter::calculateCoefficients(sampleRateHz, newCutoffHz, newResLinear,
+                                                     gTarget, e1Target, e2Target);
+
+        // no ramp from the values left by init()
+        if (mLastCutoffHz < 0.0)
+        {
+            g = gTarget;
+            e1 = e1Target;
+            e2 = e2Target;
+        }
+        mLastCutoffHz = newCutoffHz;
+        mLastResLinear = newResLinear;
+    }
+    
+    void MultiStageFilter::process(float *pLeft, float *pRight, int sampleCount)
+    {
+        processChannels<2>(pLeft, pRight, sampleCount);
+    }
+
+    void MultiStageFilter::processMono(float *pMono, int sampleCount)
+    {
+        processChannels<1>(pMono, nullptr, sampleCount);
+        for (int s=0; s < stages; s++)
+        {
+            x1[s][1] = x1[s][0];
+            x2[s][1] = x2[s][0];
+            y1[s][1] = y1[s][0];
+            y2[s][1] = y2[s][0];
+        }
+    }
+
+    template<int channelCount>
+    void MultiStageFilter::processChannels(float *pLeft, float *pRight, int sampleCount)
+    {
+        if (sampleCount <= 0) return;
+
+        float dg = (gTarget - g) / sampleCount;
+        float de1 = (e1Target - e1) / sampleCount;
+        float de2 = (e2Target - e2) / sampleCount;
+
+        for (int s=0; s < stages; s++)
+        {
+            // local copies, so the compiler can keep the whole recursion in registers
+            float sx1[2] = { x1[s][0], x1[s][1] }, sx2[2] = { x2[s][0], x2[s][1] };
+            float sy1[2] = { y1[s][0], y1[s][1] }, sy2[2] = { y2[s][0], y2[s][1] };
+            float sg = g, se1 = e1, se2 = e2;
+
+            for (int i=0; i < sampleCount; i++)
+            {
+                sg += dg;
+                se1 += de1;
+                se2 += de2;
+
+                float in[2] = { pLeft[i], channelCount == 2 ? pRight[i] : 0.0f };
+                float out[2];
+                for (int ch=0; ch < channelCount; ch++)
+                {
+                    out[ch] = sy1[ch] + ((sy1[ch] - sy2[ch]) +
+                                         (sg * (in[ch] + 2.0f * sx1[ch] + sx2[ch]) - se1 * sy1[ch] + se2 * sy2[ch]));
+                    sx2[ch] = sx1[ch];
+                    sx1[ch] = in[ch];
+                    sy2[ch] = sy1[ch];
+                    sy1[ch] = out[ch];
+                }
+                pLeft[i] = out[0];
+                if (channelCount == 2) pRight[i] = out[1];
+            }
+
+            for (int ch=0; ch < channelCount; ch++)
+            {
+                x1[s][ch] = sx1[ch];
+                x2[s][ch] = sx2[ch];
+                y1[s][ch] = sy1[ch];
+                y2[s][ch] = sy2[ch];
+            }
+        }
+
+        g = gTarget;
+        e1 = e1Target;
+        e2 = e2Target;
+    }
+
+}
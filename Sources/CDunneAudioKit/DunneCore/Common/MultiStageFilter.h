@@ -13,23 +13,51 @@
 namespace DunneCore
 {
 
+    // A stereo cascade of up to 4 ResonantLowPassFilter stages, all sharing the same coefficients.
+    // It works in single precision (see ResonantLowPassFilter::calculateCoefficients()), and
+    // filters a whole chunk per call, one stage at a time, with left and right side by side so
+    // the two channels can share vector instructions.
+    //
+    // setParameters() sets new target coefficients, which the next process() ramps to linearly,
+    // sample by sample, so a cutoff changed once per chunk sweeps smoothly rather than in steps.
+    // Every point between two stable sets of coefficients is stable too (b1 and b2 are linear in
+    // e1 and e2, and the stable region of b1, b2 is a triangle), and the gain at DC stays at 1.
     struct MultiStageFilter
     {
         static constexpr int maxStages = 4;
         int stages;
-        ResonantLowPassFilter stage[maxStages];
+
+        // coefficients: current values, and targets
+        float g, e1, e2;
+        float gTarget, e1Target, e2Target;
+
+        // state, [stage][channel]
+        float x1[maxStages][2], x2[maxStages][2];
+        float y1[maxStages][2], y2[maxStages][2];
+
+        double sampleRateHz, mLastCutoffHz, mLastResLinear;
 
         MultiStageFilter();
 
         void init(double sampleRateHz);
-        void updateSampleRate(double sampleRateHz);
+        void updateSampleRate(double sampleRate) { sampleRateHz = sampleRate; }
 
         void setStages(int nStages);
         void setParameters(double newCutoffHz, double newResLinear);
-        void setCutoff(double newCutoffHz);
-        void setResonance(double newResLinear);
-        
-        float process(float sample);
+        void setCutoff(double newCutoffHz) { setParameters(newCutoffHz, mLastResLinear); }
+        void setResonance(double newResLinear) { setParameters(mLastCutoffHz, newResLinear); }
+
+        // filter sampleCount samples of pLeft and pRight in place, ramping the coefficients from
+        // their current values to their targets across the block
+        void process(float *pLeft, float *pRight, int sampleCount);
+
+        // process() of one channel only, for a source with identical left and right: filters pMono
+        // as the left channel, then copies its state to the right, so a later stereo process()
+        // carries on exactly as if both channels had been filtered
+        void processMono(float *pMono, int sampleCount);
+
+    private:
+        template<int channelCount> void processChannels(float *pLeft, float *pRight, int sampleCount);
     };
 
 }
@@ -0,0 +1,69 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace DunneCore
+{
+
+    /// ParameterSnapshot hands a set of parameters (e.g. ADSREnvelopeParameters) from the threads
+    /// which change them, usually the UI, to the render thread, which must never wait.
+    ///
+    /// It keeps two copies. Setters change the pending copy, holding the lock via edit(). The render
+    /// thread calls apply() at the start of each render cycle, which copies pending to live only if
+    /// it has changed, and only if it can take the lock without waiting; otherwise the change is
+    /// picked up next cycle. Everything on the render thread (e.g. every voice's envelopes) uses
+    /// live, which nothing else touches.
+    template<typename T>
+    struct ParameterSnapshot
+    {
+        /// Locked access to the pending copy, for as long as the Editor exists
+        class Editor
+        {
+        public:
+            Editor(ParameterSnapshot& snapshot, bool marksChanged)
+            : owner(snapshot), lock(snapshot.mutex), isEditing(marksChanged) {}
+            Editor(Editor&& other)
+            : owner(other.owner), lock(std::move(other.lock)), isEditing(other.isEditing) { other.isEditing = false; }
+            ~Editor() { if (isEditing) owner.isChanged.store(true, std::memory_order_release); }
+
+            T* operator->() { return &owner.pending; }
+            T& operator*() { return owner.pending; }
+
+        private:
+            ParameterSnapshot& owner;
+            std::unique_lock<std::mutex> lock;
+            bool isEditing;
+        };
+
+        /// parameters as used on the render thread
+        T live;
+
+        /// For setters: the pending copy, to change
+        Editor edit() { return Editor(*this, true); }
+
+        /// For getters: the pending copy, which holds the latest values even if not yet applied
+        Editor read() { return Editor(*this, false); }
+
+        /// Render thread only: bring live up to date with pending, if possible without waiting.
+        /// Returns true if live changed.
+        bool apply()
+        {
+            if (!isChanged.load(std::memory_order_acquire)) return false;
+            if (!mutex.try_lock()) return false;
+            live = pending;
+            isChanged.store(false, std::memory_order_relaxed);
+            mutex.unlock();
+            return true;
+        }
+
+    private:
+        T pending;
+        std::mutex mutex;
+        std::atomic<bool> isChanged{false};
+    };
+
+}
@@ -5,14 +5,14 @@
 
 #include "ResonantLowPassFilter.h"
 #include "FunctionTable.h"
+#include "LookupTables.h"
 
 namespace DunneCore
 {
     // To avoid having to call sin() and cos() in setParameters() (whenever filter parameters
-    // are changed), we maintain this static sine lookup table.
-    static FunctionTable sineTable;
-    static float Sine(float phase) { return sineTable.interp_cyclic(phase); }
-    static float Cosine(float phase) { return sineTable.interp_cyclic(phase + 0.25f); }
+    // are changed), we interpolate in the compile-time sineTable (see LookupTables.h).
+    static float Sine(float phase) { return interpCyclic(sineTable.values, sineTableSize, phase); }
+    static float Cosine(float phase) { return interpCyclic(sineTable.values, sineTableSize, phase + 0.25f); }
 
     static const float kMinCutoffHz = 12.0f;
     static const float kMinResLinear = 0.1f;
@@ -21,12 +21,6 @@ namespace DunneCore
     ResonantLowPassFilter::ResonantLowPassFilter()
     {
         init(44100.0);  // sensible guess, will be overridden by init() call anyway
-
-        if (sineTable.waveTable.empty())  // build sine table only once
-        {
-            sineTable.init(2048);
-            sineTable.sinusoid();
-        }
     }
     
     void ResonantLowPassFilter::init(double sampleRateHz)
@@ -40,19 +34,24 @@ namespace DunneCore
     {
         // only calculate the filter coefficients if the parameters have changed from last time
         if (newCutoffHz == mLastCutoffHz && newResLinear == mLastResLinear) return;
-        
-        if (newCutoffHz < kMinCutoffHz) newCutoffHz = kMinCutoffHz;
-        if (newResLinear < kMinResLinear ) newResLinear = kMinResLinear;
-        if (newResLinear > kMaxResLinear ) newResLinear = kMaxResLinear;
-        
-        // convert cutoff from Hz to 0->1 normalized frequency
-        double cutoff = 2.0 * newCutoffHz / sampleRateHz;
-        if (cutoff > 0.99) cutoff = 0.99;   // clip
-        
+
+        calculateCoefficients(sampleRateHz, newCutoffHz, newResLinear, a0, a1, a2, b1, b2);
         mLastCutoffHz = newCutoffHz;
         mLastResLinear = newResLinear;
+    }
+
+    void ResonantLowPassFilter::calculateCoefficients(double sampleRateHz, double& cutoffHz, double& resLinear,
+                                                      double& a0, double& a1, double& a2, double& b1, double& b2)
+    {
+        if (cutoffHz < kMinCutoffHz) cutoffHz = kMinCutoffHz;
+        if (resLinear < kMinResLinear ) resLinear = kMinResLinear;
+        if (resLinear > kMaxResLinear ) resLinear = kMaxResLinear;
 
-        double k = 0.5 * newResLinear * Sine(float(0.5 * cutoff));
+        // convert cutoff from Hz to 0->1 normalized frequency
+        double cutoff = 2.0 * cutoffHz / sampleRateHz;
+        if (cutoff > 0.99) cutoff = 0.99;   // clip
+
+        double k = 0.5 * resLinear * Sine(float(0.5 * cutoff));
         double c1 = 0.5 * (1.0 - k) / (1.0 + k);
         double c2 = (0.5 + c1) * Cosine(float(0.5 * cutoff));
         double c3 = (0.5 + c1 - c2) * 0.25;
@@ -64,6 +63,16 @@ namespace DunneCore
         b2 = 2.0 * c1;
     }
     
+    void ResonantLowPassFilter::calculateCoefficients(double sampleRateHz, double& cutoffHz, double& resLinear,
+                                                      float& g, float& e1, float& e2)
+    {
+        double a0, a1, a2, b1, b2;
+        calculateCoefficients(sampleRateHz, cutoffHz, resLinear, a0, a1, a2, b1, b2);
+        g = float(a0);
+        e1 = float(2.0 + b1);
+        e2 = float(1.0 - b2);
+    }
+
     void ResonantLowPassFilter::process(const float *sourceP, float *destP, int inFramesToProcess)
     {
         while (inFramesToProcess--)
@@ -28,6 +28,19 @@ namespace DunneCore
         void updateSampleRate(double sampleRate) { sampleRateHz = sampleRate; }
         
         void setParameters(double newCutoffHz, double newResLinear);
+
+        // Clamp cutoffHz and resLinear to usable values, and compute the corresponding coefficients.
+        // Shared with filters which keep their coefficients elsewhere, e.g. SynthVoiceBank.
+        static void calculateCoefficients(double sampleRateHz, double& cutoffHz, double& resLinear,
+                                          double& a0, double& a1, double& a2, double& b1, double& b2);
+
+        // Single-precision form of the same coefficients, for y = y1 + (y1 - y2) + g*(x + 2*x1 + x2)
+        // - e1*y1 + e2*y2. The poles lie close to z = 1, so the feedback coefficients are kept as
+        // (small) differences from those of a double integrator, which float represents precisely.
+        // Filtering noise this way in float stays within -70 dB of the double-precision filter,
+        // for cutoffs from 12 Hz to Nyquist and resonances 0.1 to 10, at 44.1 to 96 kHz.
+        static void calculateCoefficients(double sampleRateHz, double& cutoffHz, double& resLinear,
+                                          float& g, float& e1, float& e2);
         void setCutoff(double newCutoffHz) { setParameters(newCutoffHz, mLastResLinear); }
         void setResonance(double newResLinear) { setParameters(mLastCutoffHz, newResLinear); }
         
@@ -0,0 +1,128 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// StateVariableFilter implements a low-pass TPT state-variable filter with smoothly
+// adjustable cutoff frequency and resonance.
+
+#include "StateVariableFilter.h"
+#include "FastMath.h"
+#include <math.h>
+
+namespace DunneCore
+{
+    // same limits as ResonantLowPassFilter
+    static const double kMinCutoffHz = 12.0;
+    static const double kMaxCutoffFraction = 0.495;     // of sample rate
+    static const float kMinResLinear = 0.1f;
+    static const float kMaxResLinear = 10.0f;
+
+    StateVariableFilter::StateVariableFilter()
+    {
+        init(44100.0);
+        stages = 1;
+    }
+
+    void StateVariableFilter::init(double sampleRateHz)
+    {
+        this->sampleRateHz = sampleRateHz;
+        g = k = gTarget = kTarget = 0.0f;
+        for (int s=0; s < maxStages; s++)
+            for (int ch=0; ch < 2; ch++)
+                ic1[s][ch] = ic2[s][ch] = 0.0f;
+        mLastCutoffHz = mLastResLinear = -1.0;  // force recalc of coefficients
+    }
+
+    void StateVariableFilter::setStages(int nStages)
+    {
+        if (nStages < 0) nStages = 0;
+        if (nStages > maxStages) nStages = maxStages;
+        stages = nStages;
+    }
+
+    void StateVariableFilter::setParameters(double newCutoffHz, double newResLinear)
+    {
+        if (newCutoffHz == mLastCutoffHz && newResLinear == mLastResLinear) return;
+
+        gTarget = gainFor(sampleRateHz, newCutoffHz);
+        kTarget = dampingFor(newResLinear);
+
+        // no ramp from the values left by init()
+        if (mLastCutoffHz < 0.0)
+        {
+            g = gTarget;
+            k = kTarget;
+        }
+        mLastCutoffHz = newCutoffHz;
+        mLastResLinear = newResLinear;
+    }
+
+    float StateVariableFilter::gainFor(double sampleRateHz, double cutoffHz)
+    {
+        if (cutoffHz < kMinCutoffHz) cutoffHz = kMinCutoffHz;
+        if (cutoffHz > kMaxCutoffFraction * sampleRateHz) cutoffHz = kMaxCutoffFraction * sampleRateHz;
+        return fastTan(float(M_PI * cutoffHz / sampleRateHz));
+    }
+
+    float StateVariableFilter::dampingFor(double resLinear)
+    {
+        if (resLinear < kMinResLinear) resLinear = kMinResLinear;
+        if (resLinear > kMaxResLinear) resLinear = kMaxResLinear;
+        return float(resLinear);
+    }
+
+    void StateVariableFilter::process(float *pLeft, float *pRight, int sampleCount)
+    {
+        processChannels<2>(pLeft, pRight, sampleCount);
+    }
+
+    void StateVariableFilter::processMono(float *pMono, int sampleCount)
+    {
+        processChannels<1>(pMono, nullptr, sampleCount);
+        for (int s=0; s < stages; s++)
+        {
+            ic1[s][1] = ic1[s][0];
+            ic2[s][1] = ic2[s][0];
+        }
+    }
+
+    template<int channelCount>
+    void StateVariableFilter::processChannels(float *pLeft, float *pRight, int sampleCount)
+    {
+        if (stages == 0 || sampleCount <= 0) return;
+
+        // local copies, so the compiler can keep the whole recursion in registers
+        float sg = g, sk = k;
+        float dg = (gTarget - g) / sampleCount, dk = (kTarget - k) / sampleCount;
+        float s1[maxStages][2], s2[maxStages][2];
+        for (int s=0; s < stages; s++)
+            for (int ch=0; ch < channelCount; ch++)
+            {
+                s1[s][ch] = ic1[s][ch];
+                s2[s][ch] = ic2[s][ch];
+            }
+
+        for (int i=0; i < sampleCount; i++)
+        {
+            sg += dg;
+            sk += dk;
+            float a1, a2, a3;
+            coefficients(sg, sk, a1, a2, a3);
+
+            float x[2] = { pLeft[i], channelCount == 2 ? pRight[i] : 0.0f };
+            for (int s=0; s < stages; s++)
+                for (int ch=0; ch < channelCount; ch++)
+                    x[ch] = tick(x[ch], a1, a2, a3, s1[s][ch], s2[s][ch]);
+            pLeft[i] = x[0];
+            if (channelCount == 2) pRight[i] = x[1];
+        }
+
+        g = gTarget;
+        k = kTarget;
+        for (int s=0; s < stages; s++)
+            for (int ch=0; ch < channelCount; ch++)
+            {
+                ic1[s][ch] = s1[s][ch];
+                ic2[s][ch] = s2[s][ch];
+            }
+    }
+
+}
@@ -0,0 +1,78 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// StateVariableFilter implements a low-pass state-variable filter in "topology-preserving
+// transform" form: trapezoidal integrators with the feedback loop solved exactly. Its state is
+// the pair of integrator outputs, rather than past inputs and outputs as in a direct-form
+// biquad, so it stays stable and free of zipper noise while the cutoff moves every sample.
+//
+// Resonance uses the same linear scale as ResonantLowPassFilter, 10.0 (-20 dB) to 0.1 (+20 dB),
+// taken as the damping 1/Q of each stage.
+
+#pragma once
+
+namespace DunneCore
+{
+
+    // A stereo cascade of up to 4 identical 2-pole stages. setParameters() sets new targets,
+    // which the next process() ramps to sample by sample, as LinearRamper does.
+    struct StateVariableFilter
+    {
+        static constexpr int maxStages = 4;
+        int stages;
+
+        // integrator gain g = tan(pi * cutoff / sampleRate), and damping k: current values, and targets
+        float g, k, gTarget, kTarget;
+
+        // integrator state, [stage][channel]
+        float ic1[maxStages][2], ic2[maxStages][2];
+
+        double sampleRateHz, mLastCutoffHz, mLastResLinear;
+
+        StateVariableFilter();
+
+        void init(double sampleRateHz);
+        void updateSampleRate(double sampleRate) { sampleRateHz = sampleRate; }
+
+        void setStages(int nStages);
+        void setParameters(double newCutoffHz, double newResLinear);
+
+        // filter sampleCount samples of pLeft and pRight in place, ramping the coefficients from
+        // their current values to their targets across the block
+        void process(float *pLeft, float *pRight, int sampleCount);
+
+        // process() of one channel only, for a source with identical left and right: filters pMono
+        // as the left channel, then copies its state to the right, so a later stereo process()
+        // carries on exactly as if both channels had been filtered
+        void processMono(float *pMono, int sampleCount);
+
+        // Integrator gain for cutoffHz, clamped as in ResonantLowPassFilter (12 Hz to 0.99 Nyquist),
+        // by fastTan() (see FastMath.h). Also used by LadderFilter and SynthVoiceBank.
+        static float gainFor(double sampleRateHz, double cutoffHz);
+
+        // Damping for resLinear, clamped to [0.1, 10]
+        static float dampingFor(double resLinear);
+
+        // Coefficients of one sample, for the current g and k
+        static inline void coefficients(float g, float k, float& a1, float& a2, float& a3)
+        {
+            a1 = 1.0f / (1.0f + g * (g + k));
+            a2 = g * a1;
+            a3 = g * a2;
+        }
+
+        // One sample of one stage
+        static inline float tick(float x, float a1, float a2, float a3, float& ic1, float& ic2)
+        {
+            float v3 = x - ic2;
+            float v1 = a1 * ic1 + a2 * v3;
+            float v2 = ic2 + a2 * ic1 + a3 * v3;
+            ic1 = 2.0f * v1 - ic1;
+            ic2 = 2.0f * v2 - ic2;
+            return v2;
+        }
+
+    private:
+        template<int channelCount> void processChannels(float *pLeft, float *pRight, int sampleCount);
+    };
+
+}
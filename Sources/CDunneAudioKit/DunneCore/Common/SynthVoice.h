@@ -5,9 +5,11 @@
 
 #include "EnsembleOscillator.h"
 #include "DrawbarsOscillator.h"
+#include "WavetableOscillator.h"
 #include "ADSREnvelope.h"
 #include "CoreEnvelope.h"
-#include "MultiStageFilter.h"
+#include "FunctionTable.h"
+#include "ModulationMatrix.h"
 
 namespace DunneCore
 {
@@ -27,23 +29,36 @@ namespace DunneCore
         float mixLevel;
     };
 
+    struct WavetableParameters
+    {
+        float position;         // morph position, 0 = first frame, 1 = last frame
+        float mixLevel;         // fraction, or 0 to disable oscillator
+    };
+
     struct SynthVoiceParameters
     {
         SynthOscParameters osc1, osc2;
         OrganParameters osc3;
+        WavetableParameters osc4;
         /// 1 to 4, or 0 to disable filter
         int filterStages;
+        /// see VoiceFilter::FilterType
+        int filterType;
+        /// frequency of each voice's own LFO (see kVoiceLFOSource), in cycles per chunk
+        float voiceLFOPhaseDelta;
     };
 
     struct SynthVoice
     {
         SynthVoiceParameters *pParameters;
+        const ModulationMatrix *pModulation;
 
         EnsembleOscillator osc1, osc2;
         DrawbarsOscillator osc3;
-        MultiStageFilter leftFilter, rightFilter;            // two filters (left/right)
+        WavetableOscillator osc4;
         ADSREnvelope ampEG, filterEG;
         Envelope pumpEG;
+        SharedFunctionTableOscillator voiceLFO;
 
         unsigned event = 0;      // last "event number" associated with this voice
         int noteNumber = -1;     // MIDI note number, or -1 if not playing any note
@@ -51,35 +66,51 @@ namespace DunneCore
         float noteVolume = 0;    // fraction 0.0 - 1.0, based on MIDI velocity
         
         // temporary holding variables
-        int newNoteNumber;  // holds new note number while damping note before restarting
+        int newNoteNumber;  // new note number while damping a stolen note, whose frequency is still to be set
         float newNoteVol;   // holds new note volume while damping note before restarting
         float tempGain;     // product of global volume, note volume, and amp EG
+        double filterCutoffHz;  // filter cutoff for the current chunk
+
+        // gain and filters are applied across all voices together; see SynthVoiceBank
 
-        SynthVoice(std::mt19937* gen) : noteNumber(-1), osc1(gen), osc2(gen) {}
+        SynthVoice() : noteNumber(-1) {}
+
+        // Choose the random streams of this voice's oscillators, by instance seed and voice index,
+        // and start them from the beginning, so the next init() draws the same phases every time.
+        // Phases are drawn only by init(), never per note, so no event number is needed.
+        void setRandomStream(uint32_t seed, int voiceIndex);
 
         void init(double sampleRate,
-                  WaveStack *pOsc1Stack,
-                  WaveStack *pOsc2Stack,
-                  WaveStack *pOsc3Stack,
+                  const WaveStack *pOsc1Stack,
+                  const WaveStack *pOsc2Stack,
+                  const WaveStack *pOsc3Stack,
+                  const Wavetable *pOsc4Table,
                   SynthVoiceParameters *pParameters,
                   EnvelopeParameters *pEnvParameters);
         
-        void updateAmpAdsrParameters() { ampEG.updateParams(); }
-        void updateFilterAdsrParameters() { filterEG.updateParams(); }
-        
         void start(unsigned evt, unsigned noteNumber, float frequency, float volume);
         void restart(unsigned evt, float volume);
         void restart(unsigned evt, unsigned noteNumber, float frequency, float volume);
         void release(unsigned evt);
         void stop(unsigned evt);
         
-        // return true if amp envelope is finished
+        // Compute this chunk's gain, filter cutoff and pitch, by running the operations of
+        // *pModulation on the sources it uses; vibrato is the synth's vibrato LFO sample.
+        // Return true if amp envelope is finished
         bool prepToGetSamples(float masterVol,
                               float phaseDeltaMultiplier,
                               float cutoffMultiple,
                               float cutoffStrength,
-                              float resLinear);
-        bool getSamples(int sampleCount, float *leftOuput, float *rightOutput);
+                              float vibrato);
+
+        // write sampleCount samples of mixed oscillator output, before gain and filtering,
+        // to pLeft[0], pLeft[stride], pLeft[2 * stride] ... (and likewise pRight)
+        void getOscillatorSamples(int sampleCount, float *pLeft, float *pRight, int stride);
+
+    private:
+        // getOscillatorSamples() with or without the wavetable oscillator
+        template<bool isOsc4Active>
+        void mixOscillators(int sampleCount, float *pLeft, float *pRight, int stride);
     };
 
 }
@@ -0,0 +1,82 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include "VoiceFilter.h"
+
+namespace DunneCore
+{
+
+    /// SynthVoiceBank holds the per-sample state of every CoreSynth voice past its oscillators:
+    /// gain, and the left/right filter cascades, laid out as structure-of-arrays indexed by voice.
+    /// Each voice writes its oscillator output into its own column of input[][][]; process() then
+    /// runs each step of the gain/filter cascade across all voices at once, so the inner loops
+    /// are over contiguous per-voice values, which the compiler can vectorize.
+    ///
+    /// The arithmetic is exactly that of a VoiceFilter per voice, in single precision, so the
+    /// loops run 4 or 8 voices per vector instruction.
+    struct SynthVoiceBank
+    {
+        static constexpr int maxVoices = 32;
+        static constexpr int maxStages = MultiStageFilter::maxStages;
+        static constexpr int maxChunkSize = 16;
+
+        // filter state values per voice and channel, enough for any filter type
+        static constexpr int maxStateValues = 4 * maxStages;
+
+        // oscillator output for the current chunk, [channel][sample][voice]
+        float input[2][maxChunkSize][maxVoices];
+
+        // per-voice values for the current chunk; voices which are not sounding are left alone
+        bool isActive[maxVoices];
+        float gain[maxVoices];          // product of global volume, note volume, and amp EG
+
+        // filter type of all voices; see setFilterType()
+        VoiceFilter::FilterType filterType;
+
+        // kResonantLowPass coefficients, shared by all stages and both channels of a voice: current
+        // values, and the targets process() ramps them to (see MultiStageFilter)
+        float g[maxVoices], e1[maxVoices], e2[maxVoices];
+        float gTarget[maxVoices], e1Target[maxVoices], e2Target[maxVoices];
+
+        // kStateVariable and kLadder coefficients: current values, and the targets process() ramps
+        // them to (see StateVariableFilter and LadderFilter)
+        float tptG[maxVoices], tptK[maxVoices], tptGTarget[maxVoices], tptKTarget[maxVoices];
+
+        double lastCutoffHz[maxVoices], lastResLinear[maxVoices];
+
+        // filter state, [channel][value][voice]: x1, x2, y1, y2 of each kResonantLowPass stage,
+        // ic1, ic2 of each kStateVariable stage, or the four kLadder poles
+        float state[2][maxStateValues][maxVoices];
+
+        double sampleRateHz;
+
+        SynthVoiceBank() { init(44100.0); }
+
+        void init(double sampleRate);
+
+        /// Select the filter type for all voices. Changing it re-initializes the whole bank, so call
+        /// this before setting up the voices for a chunk.
+        void setFilterType(int newType);
+
+        /// Recalculates coefficients only if the parameters have changed
+        void setFilterParameters(int voiceIndex, double newCutoffHz, double newResLinear);
+
+        /// Apply gain and filterStages filter stages (0 = no filter) to the first sampleCount
+        /// samples of input for voices [0, voiceCount), and add the results to pOutLeft/pOutRight
+        /// in voice order.
+        void process(int sampleCount, int voiceCount, int filterStages, float *pOutLeft, float *pOutRight);
+
+    private:
+        int stateValueCount(int filterStages);
+        void tptRampIncrements(int sampleCount, int voiceCount, float *dg, float *dk);
+        void finishTptRamp(int voiceCount);
+        // dispatch once per chunk to a loop compiled for the given number of stages
+        void processResonantLowPass(int sampleCount, int voiceCount, int filterStages);
+        void processStateVariable(int sampleCount, int voiceCount, int filterStages);
+        template<int filterStages> void processResonantLowPassStages(int sampleCount, int voiceCount);
+        template<int filterStages> void processStateVariableStages(int sampleCount, int voiceCount);
+        void processLadder(int sampleCount, int voiceCount);
+    };
+
+}
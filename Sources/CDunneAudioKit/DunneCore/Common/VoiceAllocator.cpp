@@ -0,0 +1,60 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "VoiceAllocator.h"
+
+namespace DunneCore
+{
+
+    void VoiceAllocator::init(int voiceCount)
+    {
+        next.assign(voiceCount, -1);
+        previous.assign(voiceCount, -1);
+        listOf.assign(voiceCount, kFree);
+        for (int i=0; i < kListCount; i++) head[i] = tail[i] = -1;
+
+        for (int v=0; v < voiceCount; v++)
+        {
+            previous[v] = v - 1;
+            next[v] = v + 1 < voiceCount ? v + 1 : -1;
+        }
+        if (voiceCount > 0)
+        {
+            head[kFree] = 0;
+            tail[kFree] = voiceCount - 1;
+        }
+    }
+
+    void VoiceAllocator::unlink(int voice)
+    {
+        int list = listOf[voice];
+        if (previous[voice] >= 0) next[previous[voice]] = next[voice];
+        else head[list] = next[voice];
+        if (next[voice] >= 0) previous[next[voice]] = previous[voice];
+        else tail[list] = previous[voice];
+    }
+
+    void VoiceAllocator::moveTo(int voice, VoiceList list)
+    {
+        unlink(voice);
+        listOf[voice] = list;
+
+        if (list == kFree)
+        {
+            // free voices are reused last in, first out
+            previous[voice] = -1;
+            next[voice] = head[kFree];
+            if (head[kFree] >= 0) previous[head[kFree]] = voice;
+            else tail[kFree] = voice;
+            head[kFree] = voice;
+        }
+        else
+        {
+            previous[voice] = tail[list];
+            next[voice] = -1;
+            if (tail[list] >= 0) next[tail[list]] = voice;
+            else head[list] = voice;
+            tail[list] = voice;
+        }
+    }
+
+}
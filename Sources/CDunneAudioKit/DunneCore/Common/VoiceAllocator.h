@@ -0,0 +1,46 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+namespace DunneCore
+{
+
+    /// VoiceAllocator tracks which voices of a pool, referred to by index, are free, held or
+    /// releasing, so finding a voice for a new note takes constant time however many there are.
+    ///
+    /// Each voice is on exactly one of three lists, linked through per-voice indices, so moving a
+    /// voice never allocates:
+    ///   free       not playing; the most recently freed first, so the same few voices stay warm
+    ///   active     playing a held note, or about to (restarting), stalest first
+    ///   releasing  in its release, stalest first
+    /// A voice moves to the tail of its list at every event which touches it (start, restart,
+    /// release), so each list stays in order of the voices' last events.
+    class VoiceAllocator
+    {
+    public:
+        enum VoiceList { kFree, kActive, kReleasing, kListCount };
+
+        /// allocates for voiceCount voices, all free, voice 0 first
+        void init(int voiceCount);
+
+        /// the next free voice, or -1 if all are in use
+        int firstFree() const { return head[kFree]; }
+
+        /// the voice to steal for a new note when none is free: the stalest releasing voice, or
+        /// else the stalest active one
+        int voiceToSteal() const { return head[kReleasing] >= 0 ? head[kReleasing] : head[kActive]; }
+
+        /// move voice to the tail of the given list
+        void moveTo(int voice, VoiceList list);
+
+    private:
+        std::vector<int> next, previous;
+        std::vector<int> listOf;
+        int head[kListCount], tail[kListCount];
+
+        void unlink(int voice);
+    };
+
+}
@@ -0,0 +1,102 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "VoiceFilter.h"
+
+namespace DunneCore
+{
+
+    void VoiceFilter::init(double sampleRate)
+    {
+        resonantLowPass.init(sampleRate);
+        stateVariable.init(sampleRate);
+        ladder.init(sampleRate);
+    }
+
+    void VoiceFilter::updateSampleRate(double sampleRate)
+    {
+        // the TPT filters' smoothing depends on sample rate, so only update it when it changes
+        if (sampleRate == resonantLowPass.sampleRateHz) return;
+
+        resonantLowPass.updateSampleRate(sampleRate);
+        stateVariable.updateSampleRate(sampleRate);
+        ladder.updateSampleRate(sampleRate);
+    }
+
+    void VoiceFilter::setType(int newType)
+    {
+        if (newType < 0 || newType >= kFilterTypeCount) newType = kResonantLowPass;
+        if (newType == type) return;
+
+        type = FilterType(newType);
+        double sampleRate = resonantLowPass.sampleRateHz;
+        switch (type)
+        {
+            case kResonantLowPass:
+                resonantLowPass.init(sampleRate);
+                break;
+            case kStateVariable:
+                stateVariable.init(sampleRate);
+                break;
+            case kLadder:
+                ladder.init(sampleRate);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void VoiceFilter::setStages(int nStages)
+    {
+        resonantLowPass.setStages(nStages);
+        stateVariable.setStages(nStages);
+    }
+
+    void VoiceFilter::setParameters(double newCutoffHz, double newResLinear)
+    {
+        switch (type)
+        {
+            case kStateVariable:
+                stateVariable.setParameters(newCutoffHz, newResLinear);
+                break;
+            case kLadder:
+                ladder.setParameters(newCutoffHz, newResLinear);
+                break;
+            default:
+                resonantLowPass.setParameters(newCutoffHz, newResLinear);
+                break;
+        }
+    }
+
+    void VoiceFilter::process(float *pLeft, float *pRight, int sampleCount)
+    {
+        switch (type)
+        {
+            case kStateVariable:
+                stateVariable.process(pLeft, pRight, sampleCount);
+                break;
+            case kLadder:
+                if (resonantLowPass.stages > 0) ladder.process(pLeft, pRight, sampleCount);
+                break;
+            default:
+                resonantLowPass.process(pLeft, pRight, sampleCount);
+                break;
+        }
+    }
+
+    void VoiceFilter::processMono(float *pMono, int sampleCount)
+    {
+        switch (type)
+        {
+            case kStateVariable:
+                stateVariable.processMono(pMono, sampleCount);
+                break;
+            case kLadder:
+                if (resonantLowPass.stages > 0) ladder.processMono(pMono, sampleCount);
+                break;
+            default:
+                resonantLowPass.processMono(pMono, sampleCount);
+                break;
+        }
+    }
+
+}
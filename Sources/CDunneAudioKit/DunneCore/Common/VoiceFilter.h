@@ -0,0 +1,52 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include "MultiStageFilter.h"
+#include "StateVariableFilter.h"
+#include "LadderFilter.h"
+
+namespace DunneCore
+{
+
+    // The stereo low-pass filter of one voice, of a selectable type. Each type keeps its own
+    // coefficients and state; setType() clears those of the newly-selected type.
+    struct VoiceFilter
+    {
+        enum FilterType
+        {
+            kResonantLowPass = 0,   // cascaded biquads (MultiStageFilter), the default
+            kStateVariable,         // cascaded TPT 2-pole stages, for fast cutoff modulation
+            kLadder,                // TPT 4-pole ladder, for fast cutoff modulation
+            kFilterTypeCount
+        };
+
+        FilterType type;
+
+        MultiStageFilter resonantLowPass;
+        StateVariableFilter stateVariable;
+        LadderFilter ladder;
+
+        VoiceFilter() : type(kResonantLowPass) {}
+
+        void init(double sampleRate);
+        void updateSampleRate(double sampleRate);
+
+        // any out-of-range value selects kResonantLowPass
+        void setType(int newType);
+
+        // number of stages of the kResonantLowPass and kStateVariable types; the ladder always
+        // has four poles, and is bypassed only when nStages is 0
+        void setStages(int nStages);
+
+        void setParameters(double newCutoffHz, double newResLinear);
+
+        // filter sampleCount samples of pLeft and pRight in place
+        void process(float *pLeft, float *pRight, int sampleCount);
+
+        // filter sampleCount samples of pMono in place, as both channels of a source whose left and
+        // right are identical; the right channel's state follows the left's
+        void processMono(float *pMono, int sampleCount);
+    };
+
+}
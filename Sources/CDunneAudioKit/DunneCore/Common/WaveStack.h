@@ -3,31 +3,102 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <stdint.h>
+
+// Resolution of the top octave of the WaveStack used by the synth oscillators, as a power of 2.
+// Supported values are 9, 10, 11 and 12 (512 to 4096 samples). Larger tables resolve low notes
+// better, but each stack occupies 2^(bits+3) bytes, so they compete with voice state for L1.
+#ifndef WAVESTACK_MAX_BITS
+#define WAVESTACK_MAX_BITS 10
+#endif
+
+// Set to 1 to have the WaveStack-based oscillators crossfade between adjacent octave levels as
+// the pitch rises, rather than switching abruptly. Costs a second table read per phase.
+#ifndef WAVESTACK_OCTAVE_CROSSFADE
+#define WAVESTACK_OCTAVE_CROSSFADE 0
+#endif
 
 namespace DunneCore
 {
 
-    // WaveStack represents a series of progressively lower-resolution sampled versions of a
-    // waveform. Client code supplies the initial waveform, at a resolution of 1024 samples,
-    // equivalent to 43.6 Hz at 44.1K samples/sec (about 23.44 cents below F1, midi note 29),
-    // and then calls initStack() to create the filtered higher-octave versions.
-    // This provides a basis for anti-aliased oscillators; see class WaveStackOscillator.
-    
-    struct WaveStack
+    // WaveStackT represents a series of progressively lower-resolution sampled versions of a
+    // waveform. Client code supplies the initial waveform, at a resolution of 2^MaxBits samples
+    // (for 1024, equivalent to 43.6 Hz at 44.1K samples/sec, about 23.44 cents below F1, midi
+    // note 29), and then calls initStack() to create the filtered higher-octave versions.
+    // This provides a basis for anti-aliased oscillators; see class EnsembleOscillator.
+
+    template<int MaxBits>
+    struct WaveStackT
     {
         // Highest-resolution rep uses 2^maxBits samples
-        static constexpr int maxBits = 10;  // 1024
+        static constexpr int maxBits = MaxBits;
+        static constexpr int tableLength = 1 << MaxBits;
 
         // maxBits also defines the number of octave levels; highest level has just 2 samples
         float *pData[maxBits];
 
-        WaveStack();
-        ~WaveStack();
+        WaveStackT();
+        ~WaveStackT();
+
+        // WaveStacks own their table memory and are normally shared, so they can't be copied
+        WaveStackT(const WaveStackT&) = delete;
+        WaveStackT& operator=(const WaveStackT&) = delete;
+
+        // Fill pWaveData with tableLength samples, then call this
+        void initStack(const std::vector<float>& waveData, int maxHarmonic=tableLength/2);
+
+        // Phase is 32-bit fixed point: a full cycle is 2^32, so it wraps by unsigned overflow, and
+        // the top (maxBits - octave) bits are the table index; the rest are the fraction.
+        float interp(int octave, uint32_t phase) const
+        {
+            const int tableBits = maxBits - octave;
+            const float *pWaveTable = pData[octave];
+            uint32_t ri = phase >> (32 - tableBits);
+            uint32_t rj = (ri + 1) & ((1u << tableBits) - 1);
+            float f = float((phase << tableBits) >> 8) * (1.0f / (1 << 24));
+            return pWaveTable[ri] + f * (pWaveTable[rj] - pWaveTable[ri]);
+        }
 
-        // Fill pWaveData with 1024 samples, then call this
-        void initStack(const std::vector<float>& waveData, int maxHarmonic=512);
+        // Crossfade from octave (octaveFade = 0) toward the more-filtered octave + 1 (octaveFade = 1)
+        float interp(int octave, uint32_t phase, float octaveFade) const
+        {
+            if (octaveFade <= 0.0f || octave + 1 >= maxBits) return interp(octave, phase);
 
-        float interp(int octave, float phase);
+            float a = interp(octave, phase);
+            float b = interp(octave + 1, phase);
+            return a + octaveFade * (b - a);
+        }
+
+        // Fixed-point phase increment for normalized frequency cyclesPerSample (must be < 1)
+        static uint32_t phaseIncrement(double cyclesPerSample)
+        {
+            double increment = cyclesPerSample * 4294967296.0;
+            if (increment < 0.0) increment = 0.0;
+            if (increment > 4294967295.0) increment = 4294967295.0;
+            return uint32_t(increment);
+        }
+
+        // Lowest octave level which can play normalized frequency phaseDelta without aliasing.
+        // If pOctaveFade is given, it receives the crossfade amount toward the next level up,
+        // which rises from 0 to 1 across the octave so level changes are seamless.
+        // The result may be >= maxBits, if phaseDelta is at or above Nyquist.
+        static int octaveFor(float phaseDelta, float *pOctaveFade=0);
+
+        // Return a fully-initialized, immutable WaveStack for the given waveform and harmonic limit.
+        // Stacks are built only once per process and shared by every caller asking for the same
+        // waveform; a stack is freed when the last shared_ptr referring to it goes away.
+        // Thread-safe, but may do FFT work, so call it from init() code, never from render().
+        static std::shared_ptr<const WaveStackT> getShared(const std::vector<float>& waveData,
+                                                           int maxHarmonic=tableLength/2);
     };
 
+    // Instantiated (in WaveStack.cpp) for each supported size only
+    extern template struct WaveStackT<9>;
+    extern template struct WaveStackT<10>;
+    extern template struct WaveStackT<11>;
+    extern template struct WaveStackT<12>;
+
+    typedef WaveStackT<WAVESTACK_MAX_BITS> WaveStack;
+
 }
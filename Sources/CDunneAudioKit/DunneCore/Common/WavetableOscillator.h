@@ -0,0 +1,68 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include "WaveStack.h"
+#include <memory>
+#include <vector>
+
+namespace DunneCore
+{
+
+    /// A Wavetable is an immutable sequence of single-cycle waveform "frames", each held as a
+    /// band-limited WaveStack so that any frame can be played at any pitch without aliasing.
+    struct Wavetable
+    {
+        std::vector<std::shared_ptr<const WaveStack>> frames;
+
+        /// Slice pSamples into consecutive frames of frameLength samples (any trailing partial
+        /// frame is ignored), and build a WaveStack for each. Frames of any other length are
+        /// resampled to the native WaveStack length (see WAVESTACK_MAX_BITS) through the frequency
+        /// domain, keeping only harmonics below both Nyquist limits, so that shortening a frame
+        /// never aliases. This does FFT work for every frame, so call it on a background thread;
+        /// see CoreSynth::loadWavetable().
+        void init(const float *pSamples, int sampleCount, int frameLength);
+
+        int frameCount() const { return int(frames.size()); }
+    };
+
+    /// WavetableOscillator is a WaveStack-based oscillator which reads two adjacent frames of a
+    /// Wavetable at the same phase, and crossfades ("morphs") between them. The morph position
+    /// is swept linearly across each block of samples, so it may be modulated at audio rate.
+    /// With no Wavetable (or an empty one) the oscillator is silent.
+    struct WavetableOscillator
+    {
+        /// current output sample rate
+        double sampleRateHz;
+
+        /// pointer to shared Wavetable
+        const Wavetable *pWavetable;
+
+        /// WaveStack octave used for all frames
+        int octave;
+
+        /// Fraction of the way through waveform, as 32-bit fixed point (see WaveStack::interp())
+        uint32_t phase;
+
+        /// normalized frequency: cycles per sample
+        float phaseDelta;
+
+        /// phaseDelta multiplier for pitchbend, vibrato
+        float phaseDeltaMultiplier;
+
+        /// morph position at end of last block: 0.0 = first frame, 1.0 = last frame
+        float position;
+
+        void init(double sampleRate, const Wavetable *pTable);
+        void setWavetable(const Wavetable *pTable) { pWavetable = pTable; }
+        void setFrequency(float frequency);
+
+        /// set the morph position directly, clamped to [0, 1]
+        void setPosition(float newPosition);
+
+        /// Render sampleCount samples to pOut (overwriting), while moving the morph position
+        /// linearly from where the last block left off to newPosition.
+        void getSamples(int sampleCount, float *pOut, float newPosition);
+    };
+
+}
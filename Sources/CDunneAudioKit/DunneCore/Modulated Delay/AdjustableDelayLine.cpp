@@ -5,64 +5,341 @@
 
 namespace DunneCore
 {
+    // Weights of the 4-point kernels for a delay of integer + fraction samples, in buffer order:
+    // the points 2, 1, 0 and -1 samples older than the integer delay. Both are exact at
+    // fraction 0, where only point 0 counts.
+    static inline void fourPointWeights(DelayInterpolation kind, float f, float *w)
+    {
+        if (kind == kLagrangeInterpolation)
+        {
+            const float fp1 = f + 1.0f, fm1 = f - 1.0f, fm2 = f - 2.0f;
+            w[0] = fp1 * f * fm1 * (1.0f / 6.0f);
+            w[1] = -0.5f * fp1 * f * fm2;
+            w[2] = 0.5f * fp1 * fm1 * fm2;
+            w[3] = -f * fm1 * fm2 * (1.0f / 6.0f);
+        }
+        else
+        {
+            const float f2 = f * f, f3 = f2 * f;
+            w[0] = 0.5f * (f3 - f2);
+            w[1] = 0.5f * f + 2.0f * f2 - 1.5f * f3;
+            w[2] = 1.0f - 2.5f * f2 + 1.5f * f3;
+            w[3] = -0.5f * f + f2 - 0.5f * f3;
+        }
+    }
+
+    // The allpass delays the 2-point stream by between 0.5 and 1.5 samples, where its coefficient
+    // is smallest, so its integer part is one less when the fraction is under a half.
+    static inline float allpassCoefficient(int& integer, float fraction)
+    {
+        if (fraction < 0.5f)
+        {
+            integer--;
+            fraction += 1.0f;
+        }
+        return (1.0f - fraction) / (1.0f + fraction);
+    }
+
     void AdjustableDelayLine::init(double sampleRate, double maxDelayMilliseconds)
     {
         sampleRateHz = sampleRate;
         maxDelayMs = maxDelayMilliseconds;
 
-        buffer.resize(int(maxDelayMs * sampleRateHz / 1000.0));
+        // reads reach two samples beyond the longest delay
+        maxDelaySamples = int(maxDelayMs * sampleRateHz / 1000.0);
+        int capacity = 1;
+        while (capacity < maxDelaySamples + 2) capacity *= 2;
+        mask = capacity - 1;
+
+        buffer.resize(capacity + guardSamples);
         clear();
         writeIndex = 0;
-        readIndex = (float)(buffer.size() - 1);
+        delayInteger = minDelaySamples;
+        delayFraction = 0.0f;
         fbFraction = 0.0f;
         output = 0.0f;
     }
-    
+
     void AdjustableDelayLine::deinit()
     {
         buffer.clear();
     }
-    
+
     void AdjustableDelayLine::clear()
     {
         std::fill(buffer.begin(), buffer.end(), 0.0f);
+        std::fill(allpassOutput, allpassOutput + maxTapCount, 0.0f);
+    }
+
+    void AdjustableDelayLine::setInterpolation(DelayInterpolation kind)
+    {
+        if (kind < 0 || kind >= kDelayInterpolationCount) return;
+        interpolation = kind;
+        minDelaySamples = kind == kLinearInterpolation ? 1 : 2;
+        if (delayInteger < minDelaySamples)
+        {
+            delayInteger = minDelaySamples;
+            delayFraction = 0.0f;
+        }
     }
-    
+
     void AdjustableDelayLine::setDelayMs(double delayMs)
     {
         if (delayMs > maxDelayMs) delayMs = maxDelayMs;
         if (delayMs < 0.0f) delayMs = 0.0f;
 
-        size_t capacity = buffer.size();
-
-        float fReadWriteGap = float(delayMs * sampleRateHz / 1000.0);
-        if (fReadWriteGap < 0.0f) fReadWriteGap = 0.0f;
-        if (fReadWriteGap > capacity) fReadWriteGap = (float)capacity;
-        readIndex = writeIndex - fReadWriteGap;
-        while (readIndex < 0.0f) readIndex += capacity;
-        while (readIndex >= capacity) readIndex -= capacity;
+        double delaySamples = delayMs * sampleRateHz / 1000.0;
+        if (delaySamples > maxDelaySamples) delaySamples = maxDelaySamples;
+        if (delaySamples < minDelaySamples) delaySamples = minDelaySamples;
+        delayInteger = int(delaySamples);
+        delayFraction = float(delaySamples - delayInteger);
     }
-    
+
     float AdjustableDelayLine::push(float sample)
     {
         if (buffer.empty()) return sample;
 
-        size_t capacity = buffer.size();
-        
-        int ri = int(readIndex);
-        float f = readIndex - ri;
-        int rj = ri + 1; if (rj >= capacity) rj -= capacity;
-        readIndex += 1.0f;
-        if (readIndex >= capacity) readIndex -= capacity;
-        
-        float si = buffer[ri];
-        float sj = buffer[rj];
-        float outSample = (1.0f - f) * si + f * sj;
-        
-        buffer[writeIndex++] = sample + fbFraction * outSample;
-        if (writeIndex >= capacity) writeIndex = 0;
-        
-        return (output = outSample);
+        float outSample;
+        read(&outSample, 1);
+        write(&sample, &outSample, 1);
+        return outSample;
+    }
+
+    // Delay d = delayInteger + delayFraction reads position writeIndex - d, between
+    // r = writeIndex - delayInteger - 1 and r + 1, weighted delayFraction and 1 - delayFraction;
+    // the 4-point kernels read from r - 1 to r + 2.
+    void AdjustableDelayLine::read(float *pDelayed, int sampleCount)
+    {
+        const int capacity = mask + 1;
+
+        if (interpolation == kAllpassInterpolation)
+        {
+            int integer = delayInteger;
+            const float coefficient = allpassCoefficient(integer, delayFraction);
+            float state = allpassOutput[0];
+            int readIndex = (writeIndex - integer - 1) & mask;
+            for (int i=0; i < sampleCount; i++)
+            {
+                state = coefficient * (buffer[readIndex + 1] - state) + buffer[readIndex];
+                pDelayed[i] = state;
+                readIndex = (readIndex + 1) & mask;
+            }
+            allpassOutput[0] = state;
+        }
+        else if (interpolation == kLinearInterpolation)
+        {
+            const float weight0 = delayFraction;
+            const float weight1 = 1.0f - delayFraction;
+
+            int readIndex = (writeIndex - delayInteger - 1) & mask;
+            for (int done=0; done < sampleCount; )
+            {
+                int count = std::min(sampleCount - done, capacity - readIndex);
+                const float *pBuffer = &buffer[readIndex];
+                float *pOut = pDelayed + done;
+                for (int i=0; i < count; i++) pOut[i] = weight0 * pBuffer[i] + weight1 * pBuffer[i + 1];
+                done += count;
+                readIndex = (readIndex + count) & mask;
+            }
+        }
+        else
+        {
+            // at a fixed delay, the 4-point kernels are a fixed 4-tap FIR
+            float w[4];
+            fourPointWeights(interpolation, delayFraction, w);
+
+            int readIndex = (writeIndex - delayInteger - 2) & mask;
+            for (int done=0; done < sampleCount; )
+            {
+                int count = std::min(sampleCount - done, capacity - readIndex);
+                const float *pBuffer = &buffer[readIndex];
+                float *pOut = pDelayed + done;
+                for (int i=0; i < count; i++)
+                    pOut[i] = w[0] * pBuffer[i] + w[1] * pBuffer[i + 1] + w[2] * pBuffer[i + 2] + w[3] * pBuffer[i + 3];
+                done += count;
+                readIndex = (readIndex + count) & mask;
+            }
+        }
+        output = pDelayed[sampleCount - 1];
+    }
+
+    void AdjustableDelayLine::write(const float *pIn, const float *pDelayed, int sampleCount)
+    {
+        const float feedback = fbFraction;
+        const int capacity = mask + 1;
+
+        for (int done=0; done < sampleCount; )
+        {
+            int count = std::min(sampleCount - done, capacity - writeIndex);
+            float *pBuffer = &buffer[writeIndex];
+            for (int i=0; i < count; i++) pBuffer[i] = pIn[done + i] + feedback * pDelayed[done + i];
+            if (writeIndex < guardSamples)
+                std::copy(&buffer[0], &buffer[guardSamples], &buffer[capacity]);
+            done += count;
+            writeIndex = (writeIndex + count) & mask;
+        }
     }
-    
+
+    void AdjustableDelayLine::process(const float *pIn, float *pDelayed, int sampleCount)
+    {
+        if (buffer.empty())
+        {
+            std::copy(pIn, pIn + sampleCount, pDelayed);
+            return;
+        }
+
+        while (sampleCount > 0)
+        {
+            int blockSize = std::min(sampleCount, maxReadAhead());
+            read(pDelayed, blockSize);
+            write(pIn, pDelayed, blockSize);
+            pIn += blockSize;
+            pDelayed += blockSize;
+            sampleCount -= blockSize;
+        }
+    }
+
+    template<DelayInterpolation kind>
+    inline float AdjustableDelayLine::readAt(float delaySamples, int offset, float& allpassState) const
+    {
+        clampDelay(delaySamples);
+        int integer = int(delaySamples);
+        float fraction = delaySamples - integer;
+
+        if (kind == kLinearInterpolation)
+        {
+            int readIndex = (writeIndex + offset - integer - 1) & mask;
+            return fraction * buffer[readIndex] + (1.0f - fraction) * buffer[readIndex + 1];
+        }
+        else if (kind == kAllpassInterpolation)
+        {
+            float coefficient = allpassCoefficient(integer, fraction);
+            int readIndex = (writeIndex + offset - integer - 1) & mask;
+            allpassState = coefficient * (buffer[readIndex + 1] - allpassState) + buffer[readIndex];
+            return allpassState;
+        }
+        else
+        {
+            float w[4];
+            fourPointWeights(kind, fraction, w);
+            const float *pBuffer = &buffer[(writeIndex + offset - integer - 2) & mask];
+            return w[0] * pBuffer[0] + w[1] * pBuffer[1] + w[2] * pBuffer[2] + w[3] * pBuffer[3];
+        }
+    }
+
+    void AdjustableDelayLine::process(const float *pIn, float *pDelayed, const float *pDelaySamples, int sampleCount)
+    {
+        if (buffer.empty())
+        {
+            std::copy(pIn, pIn + sampleCount, pDelayed);
+            return;
+        }
+
+        const int newestPoint = minDelaySamples - 1;
+        while (sampleCount > 0)
+        {
+            // extend the block while each sample's newest point still lies before its first write
+            int blockSize = 0;
+            while (blockSize < sampleCount)
+            {
+                float delaySamples = pDelaySamples[blockSize];
+                clampDelay(delaySamples);
+                if (int(delaySamples) - newestPoint <= blockSize) break;
+
+                float& state = allpassOutput[0];
+                switch (interpolation) {
+                    case kAllpassInterpolation:
+                        pDelayed[blockSize] = readAt<kAllpassInterpolation>(delaySamples, blockSize, state);
+                        break;
+                    case kHermiteInterpolation:
+                        pDelayed[blockSize] = readAt<kHermiteInterpolation>(delaySamples, blockSize, state);
+                        break;
+                    case kLagrangeInterpolation:
+                        pDelayed[blockSize] = readAt<kLagrangeInterpolation>(delaySamples, blockSize, state);
+                        break;
+                    case kLinearInterpolation:
+                    default:
+                        pDelayed[blockSize] = readAt<kLinearInterpolation>(delaySamples, blockSize, state);
+                        break;
+                }
+                blockSize++;
+            }
+            output = pDelayed[blockSize - 1];
+            write(pIn, pDelayed, blockSize);
+            pIn += blockSize;
+            pDelayed += blockSize;
+            pDelaySamples += blockSize;
+            sampleCount -= blockSize;
+        }
+    }
+
+    void AdjustableDelayLine::processTaps(const float *pIn, float *pDelayed, const float *const *ppTapDelays,
+                                          int tapCount, int sampleCount)
+    {
+        if (buffer.empty())
+        {
+            std::copy(pIn, pIn + sampleCount, pDelayed);
+            return;
+        }
+
+        // one loop per kernel, so that none branches on the kind per sample
+        switch (interpolation) {
+            case kAllpassInterpolation:
+                processTapsWith<kAllpassInterpolation>(pIn, pDelayed, ppTapDelays, tapCount, sampleCount);
+                break;
+            case kHermiteInterpolation:
+                processTapsWith<kHermiteInterpolation>(pIn, pDelayed, ppTapDelays, tapCount, sampleCount);
+                break;
+            case kLagrangeInterpolation:
+                processTapsWith<kLagrangeInterpolation>(pIn, pDelayed, ppTapDelays, tapCount, sampleCount);
+                break;
+            case kLinearInterpolation:
+            default:
+                processTapsWith<kLinearInterpolation>(pIn, pDelayed, ppTapDelays, tapCount, sampleCount);
+                break;
+        }
+    }
+
+    template<DelayInterpolation kind>
+    void AdjustableDelayLine::processTapsWith(const float *pIn, float *pDelayed, const float *const *ppTapDelays,
+                                              int tapCount, int sampleCount)
+    {
+        const float tapGain = 1.0f / tapCount;
+        const int newestPoint = minDelaySamples - 1;
+
+        for (int start=0; start < sampleCount; )
+        {
+            // no sample of a block no longer than the shortest delay reads what the block writes;
+            // whole samples are all that count, and an int minimum vectorizes where a float can't
+            int shortestDelay = maxDelaySamples;
+            for (int t=0; t < tapCount; t++)
+            {
+                const float *pDelays = ppTapDelays[t] + start;
+                for (int i=0; i < sampleCount - start; i++)
+                    shortestDelay = std::min(shortestDelay, int(pDelays[i]));
+            }
+            shortestDelay = std::max(shortestDelay, minDelaySamples);
+            int blockSize = std::min(sampleCount - start, shortestDelay - newestPoint);
+
+            // tap by tap, each a loop across the block, the first into pDelayed, the rest added on
+            const float *pDelays = ppTapDelays[0] + start;
+            for (int i=0; i < blockSize; i++)
+                pDelayed[i] = readAt<kind>(pDelays[i], i, allpassOutput[0]);
+            for (int t=1; t < tapCount; t++)
+            {
+                pDelays = ppTapDelays[t] + start;
+                for (int i=0; i < blockSize; i++)
+                    pDelayed[i] += readAt<kind>(pDelays[i], i, allpassOutput[t]);
+            }
+            if (tapCount > 1)
+                for (int i=0; i < blockSize; i++) pDelayed[i] *= tapGain;
+
+            output = pDelayed[blockSize - 1];
+            write(pIn, pDelayed, blockSize);
+            pIn += blockSize;
+            pDelayed += blockSize;
+            start += blockSize;
+        }
+    }
+
 }
@@ -5,31 +5,101 @@
 
 namespace DunneCore
 {
+    /// how AdjustableDelayLine reads between samples, cheapest first
+    enum DelayInterpolation
+    {
+        kLinearInterpolation,   // 2 points; dulls the highs, more so the nearer the delay to half a sample
+        kAllpassInterpolation,  // 1st-order allpass: flat magnitude, but recursive, so not vectorizable
+        kHermiteInterpolation,  // 4-point, 3rd-order Hermite
+        kLagrangeInterpolation, // 4-point, 3rd-order Lagrange: flattest of the three at high frequencies
+        kDelayInterpolationCount
+    };
+
+    /// AdjustableDelayLine is a feedback delay with a fractional, interpolated delay of 1 sample
+    /// (2 for all but linear interpolation) up to maxDelayMilliseconds.
+    ///
+    /// The ring buffer is a power of two long, so positions wrap with a mask, plus guard samples
+    /// mirroring the first few, so an interpolation's points never need wrapping. Blocks are
+    /// handled as a read of all their outputs, then a write of all their inputs plus feedback; a
+    /// block never reaches as far forward as the newest point its reads need, so it never reads
+    /// what it writes. Each half is a plain loop over contiguous samples, split where the buffer
+    /// wraps, which the compiler can vectorize.
     class AdjustableDelayLine {
+    public:
+        /// most taps processTaps() can read at once
+        static constexpr int maxTapCount = 8;
+
+    private:
+        static constexpr int guardSamples = 3;
+
         double sampleRateHz;
         double maxDelayMs;
         float fbFraction;
-        std::vector<float> buffer;
+        std::vector<float> buffer;  // mask + 1 samples, then the guard samples
+        int mask;
+        int maxDelaySamples;
         int writeIndex;
-        float readIndex;
+        int delayInteger;           // delay is delayInteger + delayFraction samples
+        float delayFraction;
         float output;
-        
+        DelayInterpolation interpolation;
+        int minDelaySamples;        // 1, or 2 for kernels reading a point a sample newer
+        float allpassOutput[maxTapCount];   // each tap's last allpass output
+
+        void clampDelay(float& delaySamples) const
+        {
+            if (delaySamples > maxDelaySamples) delaySamples = (float)maxDelaySamples;
+            if (delaySamples < minDelaySamples) delaySamples = (float)minDelaySamples;
+        }
+
+        // the sample delaySamples before the one to be written offset samples from now
+        template<DelayInterpolation kind>
+        float readAt(float delaySamples, int offset, float& allpassState) const;
+
+        template<DelayInterpolation kind>
+        void processTapsWith(const float *pIn, float *pDelayed, const float *const *ppTapDelays,
+                             int tapCount, int sampleCount);
+
     public:
+        AdjustableDelayLine() : interpolation(kLinearInterpolation), minDelaySamples(1) {}
         ~AdjustableDelayLine() { deinit(); }
-        
+
         void init(double sampleRate, double maxDelayMilliseconds);
         void deinit();
-        
+
         void clear();
 
         double getMaxDelayMs() { return maxDelayMs; }
+        double getSampleRate() { return sampleRateHz; }
 
         void setDelayMs(double delayMs);
         void setFeedback(float feedback) { fbFraction = feedback; }
- 
+
+        void setInterpolation(DelayInterpolation kind);
+        DelayInterpolation getInterpolation() { return interpolation; }
+
+        /// one sample in, one delayed sample out, at the delay set by setDelayMs()
         float push(float sample);
 
+        /// sampleCount samples at the delay set by setDelayMs(), delayed output to pDelayed, which
+        /// must not overlap pIn
+        void process(const float *pIn, float *pDelayed, int sampleCount);
+
+        /// the same, but each sample at its own delay, pDelaySamples[i] samples, e.g. modulated
+        void process(const float *pIn, float *pDelayed, const float *pDelaySamples, int sampleCount);
+
+        /// the same, but reading tapCount taps, tap t's delays in ppTapDelays[t], and delivering
+        /// their mean; the mean is also what feeds back
+        void processTaps(const float *pIn, float *pDelayed, const float *const *ppTapDelays,
+                         int tapCount, int sampleCount);
+
+        /// For feeding delay lines into each other: read() then write() a block of at most
+        /// maxReadAhead() samples, at the delay set by setDelayMs(), as process() does.
+        int maxReadAhead() const { return delayInteger - (minDelaySamples - 1); }
+        void read(float *pDelayed, int sampleCount);
+        void write(const float *pIn, const float *pDelayed, int sampleCount);
+
         float getOutput() { return output; }
     };
-    
+
 }
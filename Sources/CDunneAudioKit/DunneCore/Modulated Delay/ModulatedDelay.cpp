@@ -6,15 +6,45 @@
 #include "AdjustableDelayLine.h"
 #include "FunctionTable.h"
 
+#include <algorithm>
+#include <math.h>
+
 struct ModulatedDelay::InternalData
 {
     DunneCore::AdjustableDelayLine leftDelayLine, rightDelayLine;
     DunneCore::FunctionTableOscillator modOscillator;
+    float sampleRate, samplesPerMs;
+
+    // The LFO runs at a control rate, once per controlInterval() samples, at most
+    // maxControlInterval. Between its values each tap's delay ramps linearly, from delayFrom to
+    // delayTo samples, over segmentLength samples, and segmentPosition counts those done so far.
+    // The LFO steps one ramp ahead, so nextSegmentLength is the length of the ramp after this
+    // one. activeTapCount is the tapCount the ramps were computed for.
+    static constexpr int maxControlInterval = 16;
+    static constexpr int maxTapCount = DunneCore::AdjustableDelayLine::maxTapCount;
+    float leftDelayFrom[maxTapCount] = {}, leftDelayTo[maxTapCount] = {};
+    float rightDelayFrom[maxTapCount] = {}, rightDelayTo[maxTapCount] = {};
+    int activeTapCount;
+    int segmentLength, nextSegmentLength;
+    int segmentPosition;
+    bool isFirstSegment;
+
+    // the control interval, and the rate and depth it was chosen for
+    int interval;
+    float intervalModFreqHz, intervalDepthFraction;
+
+    // The delay lines run in blocks of up to blockSize samples, each tap's delay for every sample
+    // filled in from however many ramps the block spans, so a short control interval costs only
+    // the LFO's extra values.
+    static constexpr int blockSize = 16;
+    float leftDelays[maxTapCount][blockSize], rightDelays[maxTapCount][blockSize];
+    float leftDelayed[blockSize], rightDelayed[blockSize];
 };
 
 ModulatedDelay::ModulatedDelay(ModulatedDelayType type)
 : modFreqHz(1.0f)
 , modDepthFraction(0.0f)
+, tapCount(kChorusDefaultTapCount)
 , effectType(type), data(new InternalData)
 {
 }
@@ -46,6 +76,80 @@ void ModulatedDelay::init(int channelCount, double sampleRate)
     data->rightDelayLine.init(sampleRate, maxDelayMs);
     data->leftDelayLine.setDelayMs(minDelayMs);
     data->rightDelayLine.setDelayMs(minDelayMs);
+    data->sampleRate = float(sampleRate);
+    data->samplesPerMs = float(sampleRate / 1000.0);
+
+    data->activeTapCount = tapCount;
+    data->segmentLength = data->nextSegmentLength = InternalData::maxControlInterval;
+    data->segmentPosition = data->segmentLength;
+    data->isFirstSegment = true;
+    data->intervalModFreqHz = data->intervalDepthFraction = -1.0f;
+}
+
+void ModulatedDelay::nextControlPoint()
+{
+    const int maxTapCount = InternalData::maxTapCount;
+    float modLeft[maxTapCount], modRight[maxTapCount];
+    float freqHz = modFreqHz, depthFraction = modDepthFraction;
+    if (freqHz != data->intervalModFreqHz || depthFraction != data->intervalDepthFraction)
+    {
+        data->interval = controlInterval(freqHz, depthFraction);
+        data->intervalModFreqHz = freqHz;
+        data->intervalDepthFraction = depthFraction;
+        data->modOscillator.setFrequency(data->interval * freqHz);
+    }
+    data->segmentLength = data->nextSegmentLength;
+    data->nextSegmentLength = data->interval;
+    data->modOscillator.getSamples(modLeft, modRight, tapCount);
+
+    for (int t=0; t < tapCount; t++)
+    {
+        float leftDelayMs = midDelayMs + delayRangeMs * modDepthFraction * modLeft[t];
+        float rightDelayMs = midDelayMs + delayRangeMs * modDepthFraction * modRight[t];
+        switch (effectType) {
+            case kFlanger:
+                leftDelayMs = minDelayMs + delayRangeMs * modDepthFraction * (1.0f + modLeft[t]);
+                rightDelayMs = minDelayMs + delayRangeMs * modDepthFraction * (1.0f + modRight[t]);
+                break;
+
+            case kChorus:
+            default:
+                break;
+        }
+
+        // a tap just added has no ramp to continue, so starts where it is headed
+        bool isNewTap = t >= data->activeTapCount;
+        data->leftDelayFrom[t] = data->leftDelayTo[t];
+        data->rightDelayFrom[t] = data->rightDelayTo[t];
+        data->leftDelayTo[t] = leftDelayMs * data->samplesPerMs;
+        data->rightDelayTo[t] = rightDelayMs * data->samplesPerMs;
+        if (isNewTap)
+        {
+            data->leftDelayFrom[t] = data->leftDelayTo[t];
+            data->rightDelayFrom[t] = data->rightDelayTo[t];
+        }
+    }
+    data->activeTapCount = tapCount;
+    data->segmentPosition = 0;
+    data->isFirstSegment = false;
+}
+
+// A linear ramp gets the delay most wrong where it cuts a corner of the LFO's waveform (the table
+// is linearly interpolated, and the triangle has its peaks), by a number of samples growing as the
+// depth times the sample rate times the LFO cycles per interval to the power 1.5. Halve the
+// interval until that is small enough to null at -65 dB or better, at every rate and depth and
+// sample rate (see DelayLineBenchmark); at the defaults it stays the longest.
+int ModulatedDelay::controlInterval(float freqHz, float depthFraction)
+{
+    const float maxCornerError = 0.119f;
+    int interval = InternalData::maxControlInterval;
+    while (interval > 1)
+    {
+        float cycles = freqHz * interval / data->sampleRate;
+        if (depthFraction * data->sampleRate * cycles * sqrtf(cycles) <= maxCornerError) break;
+        interval /= 2;
+    }
+    return interval;
 }
 
 void ModulatedDelay::deinit()
@@ -57,7 +161,23 @@ void ModulatedDelay::deinit()
 
 void ModulatedDelay::setModFrequencyHz(float freq)
 {
-    data->modOscillator.setFrequency(freq);
+    modFreqHz = freq;
+}
+
+void ModulatedDelay::setTapCount(int count)
+{
+    tapCount = std::max(kChorusMinTapCount, std::min(count, kChorusMaxTapCount));
+}
+
+void ModulatedDelay::setInterpolation(DunneCore::DelayInterpolation kind)
+{
+    data->leftDelayLine.setInterpolation(kind);
+    data->rightDelayLine.setInterpolation(kind);
+}
+
+DunneCore::DelayInterpolation ModulatedDelay::getInterpolation()
+{
+    return data->leftDelayLine.getInterpolation();
 }
 
 void ModulatedDelay::setLeftFeedback(float feedback)
@@ -70,42 +190,73 @@ void ModulatedDelay::setRightFeedback(float feedback)
     data->rightDelayLine.setFeedback(feedback);
 }
 
+int ModulatedDelay::fillDelays(int sampleCount)
+{
+    int filled = 0;
+    while (filled < sampleCount)
+    {
+        if (data->segmentPosition == data->segmentLength)
+        {
+            // all of a block's samples have the same taps
+            if (filled > 0 && tapCount != data->activeTapCount) break;
+
+            // the very first ramp starts from the LFO's first value
+            if (data->isFirstSegment) nextControlPoint();
+            nextControlPoint();
+        }
+        int count = std::min(sampleCount - filled, data->segmentLength - data->segmentPosition);
+
+        for (int t=0; t < data->activeTapCount; t++)
+        {
+            float leftFrom = data->leftDelayFrom[t], rightFrom = data->rightDelayFrom[t];
+            float leftStep = (data->leftDelayTo[t] - leftFrom) / data->segmentLength;
+            float rightStep = (data->rightDelayTo[t] - rightFrom) / data->segmentLength;
+            float *pLeft = data->leftDelays[t] + filled;
+            float *pRight = data->rightDelays[t] + filled;
+            for (int i=0; i < count; i++)
+            {
+                pLeft[i] = leftFrom + leftStep * (data->segmentPosition + i);
+                pRight[i] = rightFrom + rightStep * (data->segmentPosition + i);
+            }
+        }
+
+        data->segmentPosition += count;
+        filled += count;
+    }
+    return filled;
+}
+
 void ModulatedDelay::Render(unsigned channelCount, unsigned sampleCount,
                               float *inBuffers[], float *outBuffers[])
 {
-    float *pInLeft   = inBuffers[0];
-    float *pInRight  = inBuffers[1];
-    float *pOutLeft  = outBuffers[0];
-    float *pOutRight = outBuffers[1];
-    
-    for (int i=0; i < (int)sampleCount; i++)
+    const float dryFraction = 1.0f - dryWetMix;
+    const int blockSize = InternalData::blockSize;
+
+    const float *leftDelays[InternalData::maxTapCount], *rightDelays[InternalData::maxTapCount];
+    for (int t=0; t < InternalData::maxTapCount; t++)
     {
-        float modLeft, modRight;
-        data->modOscillator.getSamples(&modLeft, &modRight);
-        
-        float leftDelayMs = midDelayMs + delayRangeMs * modDepthFraction * modLeft;
-        float rightDelayMs = midDelayMs + delayRangeMs * modDepthFraction * modRight;
-        switch (effectType) {
-            case kFlanger:
-                leftDelayMs = minDelayMs + delayRangeMs * modDepthFraction * (1.0f + modLeft);
-                rightDelayMs = minDelayMs + delayRangeMs * modDepthFraction * (1.0f + modRight);
-                break;
-                
-            case kChorus:
-            default:
-                break;
-        }
-        data->leftDelayLine.setDelayMs(leftDelayMs);
-        data->rightDelayLine.setDelayMs(rightDelayMs);
-        
-        float dryFraction = 1.0f - dryWetMix;
-        *pOutLeft++ = dryFraction * (*pInLeft) + dryWetMix * data->leftDelayLine.push(*pInLeft);
-        pInLeft++;
+        leftDelays[t] = data->leftDelays[t];
+        rightDelays[t] = data->rightDelays[t];
+    }
+
+    for (int offset=0; offset < (int)sampleCount; )
+    {
+        int count = fillDelays(std::min((int)sampleCount - offset, blockSize));
+        const int taps = data->activeTapCount;
+
+        const float *pInLeft = inBuffers[0] + offset;
+        float *pOutLeft = outBuffers[0] + offset;
+        data->leftDelayLine.processTaps(pInLeft, data->leftDelayed, leftDelays, taps, count);
+        for (int i=0; i < count; i++) pOutLeft[i] = dryFraction * pInLeft[i] + dryWetMix * data->leftDelayed[i];
+
         if (channelCount > 1)
         {
-            *pOutRight++ = dryFraction * (*pInRight) + dryWetMix * data->rightDelayLine.push(*pInRight);
-            pInRight++;
+            const float *pInRight = inBuffers[1] + offset;
+            float *pOutRight = outBuffers[1] + offset;
+            data->rightDelayLine.processTaps(pInRight, data->rightDelayed, rightDelays, taps, count);
+            for (int i=0; i < count; i++) pOutRight[i] = dryFraction * pInRight[i] + dryWetMix * data->rightDelayed[i];
         }
+
+        offset += count;
     }
-    
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "ModulatedDelay_Typedefs.h"
+#include "AdjustableDelayLine.h"
 
 #import <memory>
 
@@ -26,16 +27,36 @@ public:
     void setRightFeedback(float feedback);
     
     void setDryWetMix(float mix) { dryWetMix = mix; }
+
+    // Ensemble: the number of taps read from each channel's delay line, their LFO phases spread
+    // evenly over the cycle, 1 to kChorusMaxTapCount; takes effect at the next control point
+    void setTapCount(int count);
+    int getTapCount() { return tapCount; }
+
+    // how the delay lines read between samples; linear by default. Call it from the thread that
+    // calls Render(), which reads the state it changes.
+    void setInterpolation(DunneCore::DelayInterpolation kind);
+    DunneCore::DelayInterpolation getInterpolation();
         
     void Render(unsigned channelCount, unsigned sampleCount, float *inBuffers[], float *outBuffers[]);
     
 protected:
     float minDelayMs, maxDelayMs, midDelayMs, delayRangeMs;
     float modFreqHz, modDepthFraction, dryWetMix;
+    int tapCount;
     ModulatedDelayType effectType;
 
     struct InternalData;
     std::unique_ptr<InternalData> data;
+
+    // take the LFO's next control-rate value, and start ramping the delays towards it
+    void nextControlPoint();
+
+    // samples from one control point to the next: fewer, the faster and deeper the modulation
+    int controlInterval(float freqHz, float depthFraction);
+
+    // each tap's delay for up to sampleCount samples; returns how many it filled
+    int fillDelays(int sampleCount);
 };
 
 #endif
@@ -0,0 +1,77 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "ModulatedDelayNullTest.h"
+#include "ModulatedDelay.h"
+#include "ModulatedDelay_Defines.h"
+
+#include "AdjustableDelayLine.h"
+#include "FunctionTable.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+namespace DunneCore
+{
+    // ModulatedDelay with its LFO and delay computed every sample, the LFO's phase in double: a
+    // float phase, stepped every sample, drifts by more than the control rate changes anything
+    static void renderReference(ModulatedDelayType type, float modFrequencyHz, float depth, float feedback,
+                                float mix, const float *pIn, float *pOut, int count, double sampleRate)
+    {
+        float minDelayMs = type == kFlanger ? kFlangerMinDelayMs : kChorusMinDelayMs;
+        float maxDelayMs = type == kFlanger ? kFlangerMaxDelayMs : kChorusMaxDelayMs;
+        float delayRangeMs = 0.5f * (maxDelayMs - minDelayMs);
+        float midDelayMs = 0.5f * (minDelayMs + maxDelayMs);
+
+        FunctionTableOscillator lfo;
+        lfo.init(sampleRate, modFrequencyHz);
+        if (type == kFlanger) lfo.waveTable.triangle();
+        else lfo.waveTable.sinusoid();
+        AdjustableDelayLine line;
+        line.init(sampleRate, maxDelayMs);
+        line.setFeedback(feedback);
+
+        std::vector<float> delaySamples(count), delayed(count);
+        for (int i=0; i < count; i++)
+        {
+            double phase = fmod(i * double(modFrequencyHz) / sampleRate, 1.0);
+            float modLeft = lfo.waveTable.interp_cyclic(float(phase));
+            float delayMs = type == kFlanger ? minDelayMs + delayRangeMs * depth * (1.0f + modLeft)
+                                             : midDelayMs + delayRangeMs * depth * modLeft;
+            delaySamples[i] = float(delayMs * sampleRate / 1000.0);
+        }
+        line.process(pIn, delayed.data(), delaySamples.data(), count);
+        for (int i=0; i < count; i++) pOut[i] = (1.0f - mix) * pIn[i] + mix * delayed[i];
+    }
+
+    double modulatedDelayNullTestDb(ModulatedDelayType type, float modFrequencyHz, float depth,
+                                    const float *pIn, int sampleCount, double sampleRate)
+    {
+        const float feedback = 0.3f, mix = 0.5f;
+        const int chunkSize = 512;
+
+        ModulatedDelay effect(type);
+        effect.setModDepthFraction(depth);
+        effect.init(1, sampleRate);
+        effect.setModFrequencyHz(modFrequencyHz);
+        effect.setLeftFeedback(feedback);
+        effect.setDryWetMix(mix);
+        std::vector<float> output(sampleCount), reference(sampleCount);
+        for (int i=0; i < sampleCount; i += chunkSize)
+        {
+            float *inBuffers[1] = { const_cast<float *>(pIn) + i };
+            float *outBuffers[1] = { output.data() + i };
+            effect.Render(1, std::min(chunkSize, sampleCount - i), inBuffers, outBuffers);
+        }
+        renderReference(type, modFrequencyHz, depth, feedback, mix, pIn, reference.data(), sampleCount, sampleRate);
+
+        double differencePower = 0.0, referencePower = 0.0;
+        for (int i=0; i < sampleCount; i++)
+        {
+            double difference = output[i] - reference[i];
+            differencePower += difference * difference;
+            referencePower += double(reference[i]) * reference[i];
+        }
+        return 10.0 * log10(differencePower / referencePower + 1e-30);
+    }
+}
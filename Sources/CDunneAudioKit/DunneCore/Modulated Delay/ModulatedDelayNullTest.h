@@ -0,0 +1,15 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#pragma once
+
+#include "ModulatedDelay_Typedefs.h"
+
+namespace DunneCore
+{
+    /// Null test for ModulatedDelay's control-rate LFO: sampleCount samples from pIn through the
+    /// effect (one channel, feedback 0.3, mix 0.5), and through the same with its LFO and delay
+    /// computed every sample. Returns the difference between the two, relative to the latter,
+    /// in dB. Used by DelayLineBenchmark and the tests.
+    double modulatedDelayNullTestDb(ModulatedDelayType type, float modFrequencyHz, float depth,
+                                    const float *pIn, int sampleCount, double sampleRate);
+}
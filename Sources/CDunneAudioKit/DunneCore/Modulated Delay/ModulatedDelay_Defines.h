@@ -20,6 +20,7 @@
 #define kChorusDefaultDepth          0.25f
 #define kChorusDefaultFeedback       0.00f
 #define kChorusDefaultMix            0.25f
+#define kChorusDefaultTapCount       1
 
 // MARK: Flanger Defaults
 #define kFlangerDefaultModFreqHz     1.00f
@@ -39,6 +40,8 @@
 #define kChorusMaxFeedback           0.95f
 #define kChorusMinDryWetMix          0.00f
 #define kChorusMaxDryWetMix          1.00f
+#define kChorusMinTapCount           1
+#define kChorusMaxTapCount           8
 
 // MARK: Flanger Ranges
 #define kFlangerMinModFreqHz         0.10f
@@ -1,9 +1,13 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "StereoDelay.h"
+#include <algorithm>
 
 namespace DunneCore
 {
+    // std::min() takes it by reference, so C++14 needs its definition
+    constexpr int StereoDelay::blockSize;
+
     void StereoDelay::init(double sampleRate, double maxDelayMs)
     {
         delayLine1.init(sampleRate, maxDelayMs);
@@ -28,6 +32,12 @@ namespace DunneCore
         setFeedback(feedbackFraction);
     }
 
+    void StereoDelay::setInterpolation(DelayInterpolation kind)
+    {
+        delayLine1.setInterpolation(kind);
+        delayLine2.setInterpolation(kind);
+    }
+
     void StereoDelay::setDelayMs(double delayMs)
     {
         delayLine1.setDelayMs(delayMs);
@@ -48,28 +58,45 @@ namespace DunneCore
 
     void StereoDelay::render(int sampleCount, const float *inBuffers[], float *outBuffers[])
     {
-        if (pingPongMode)
+        float left[blockSize], right[blockSize];
+
+        for (int offset = 0; offset < sampleCount; )
         {
-            for (int i = 0; i < sampleCount; i++)
-            {
-                float inputSample = 0.5f * (inBuffers[0][i] + inBuffers[1][i]);
-                float leftSample = delayLine1.push(inputSample + feedbackFraction * delayLine2.getOutput());
-                float rightSample = delayLine2.push(leftSample);
+            const float *pInLeft = inBuffers[0] + offset;
+            const float *pInRight = inBuffers[1] + offset;
+            int count = std::min(sampleCount - offset, blockSize);
 
-                outBuffers[0][i] = (1.0f - dryWetMixFraction) * leftSample + dryWetMixFraction * inBuffers[0][i];
-                outBuffers[1][i] = (1.0f - dryWetMixFraction) * rightSample + dryWetMixFraction * inBuffers[1][i];
+            if (pingPongMode)
+            {
+                // line 1 takes the mono input plus feedback from line 2's previous output, line 2
+                // takes line 1's output; reading both before writing either keeps that order
+                count = std::min(count, std::min(delayLine1.maxReadAhead(), delayLine2.maxReadAhead()));
+                float lineInput[blockSize];
+                float previousRight = delayLine2.getOutput();
+                delayLine1.read(left, count);
+                delayLine2.read(right, count);
+                for (int i = 0; i < count; i++)
+                {
+                    lineInput[i] = 0.5f * (pInLeft[i] + pInRight[i]) + feedbackFraction * previousRight;
+                    previousRight = right[i];
+                }
+                delayLine1.write(lineInput, left, count);
+                delayLine2.write(left, right, count);
             }
-        }
-        else
-        {
-            for (int i = 0; i < sampleCount; i++)
+            else
             {
-                float leftSample = delayLine1.push(inBuffers[0][i]);
-                float rightSample = delayLine2.push(inBuffers[1][i]);
+                delayLine1.process(pInLeft, left, count);
+                delayLine2.process(pInRight, right, count);
+            }
 
-                outBuffers[0][i] = (1.0f - dryWetMixFraction) * leftSample + dryWetMixFraction * inBuffers[0][i];
-                outBuffers[1][i] = (1.0f - dryWetMixFraction) * rightSample + dryWetMixFraction * inBuffers[1][i];
+            float *pOutLeft = outBuffers[0] + offset;
+            float *pOutRight = outBuffers[1] + offset;
+            for (int i = 0; i < count; i++)
+            {
+                pOutLeft[i] = (1.0f - dryWetMixFraction) * left[i] + dryWetMixFraction * pInLeft[i];
+                pOutRight[i] = (1.0f - dryWetMixFraction) * right[i] + dryWetMixFraction * pInRight[i];
             }
+            offset += count;
         }
     }
 }
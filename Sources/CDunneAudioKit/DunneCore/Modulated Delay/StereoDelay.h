@@ -12,6 +12,9 @@ namespace DunneCore
         bool pingPongMode;
 
         AdjustableDelayLine delayLine1, delayLine2;
+
+        // render() works in blocks of at most this many samples
+        static constexpr int blockSize = 64;
         
     public:
         StereoDelay() : feedbackFraction(0.0f), dryWetMixFraction(0.5f), pingPongMode(false) {}
@@ -26,8 +29,10 @@ namespace DunneCore
         void setDelayMs(double delayMs);
         void setFeedback(float fraction);
         void setDryWetMix(float fraction);
+        void setInterpolation(DelayInterpolation kind);
         
         bool getPingPongMode() { return pingPongMode; }
+        DelayInterpolation getInterpolation() { return delayLine1.getInterpolation(); }
 
         void render(int sampleCount, const float *inBuffers[], float *outBuffers[]);
     };
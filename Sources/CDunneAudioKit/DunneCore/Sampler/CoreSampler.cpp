@@ -3,7 +3,9 @@
 #include "CoreSampler.h"
 #include "SamplerVoice.h"
 #include "FunctionTable.h"
+#include "LookupTables.h"
 #include "SustainPedalLogic.h"
+#include "ParameterSnapshot.h"
 
 #include <math.h>
 #include <list>
@@ -24,27 +26,40 @@ struct CoreSampler::InternalData {
     // maps MIDI note numbers to "closest" samples (all velocity layers)
     std::list<DunneCore::KeyMappedSampleBuffer*> keyMap[MIDI_NOTENUMBERS];
     
-    DunneCore::AHDSHREnvelopeParameters ampEnvelopeParameters;
-    DunneCore::ADSREnvelopeParameters filterEnvelopeParameters;
-    DunneCore::ADSREnvelopeParameters pitchEnvelopeParameters;
+    // envelope parameters: the setters may be called on any thread, and the render thread picks
+    // up their changes (see applyParameterChanges()) before starting notes or rendering
+    DunneCore::ParameterSnapshot<DunneCore::AHDSHREnvelopeParameters> ampEnvelopeParameters;
+    DunneCore::ParameterSnapshot<DunneCore::ADSREnvelopeParameters> filterEnvelopeParameters;
+    DunneCore::ParameterSnapshot<DunneCore::ADSREnvelopeParameters> pitchEnvelopeParameters;
     
     // table of voice resources
     DunneCore::SamplerVoice voice[MAX_POLYPHONY];
     
     // one vibrato LFO shared by all voices
-    DunneCore::FunctionTableOscillator vibratoLFO;
+    DunneCore::SharedFunctionTableOscillator vibratoLFO;
     
     DunneCore::SustainPedalLogic pedalLogic;
     
     // tuning table
     float tuningTable[128];
+    
+    // render thread only
+    void applyParameterChanges()
+    {
+        ampEnvelopeParameters.apply();
+        filterEnvelopeParameters.apply();
+        pitchEnvelopeParameters.apply();
+    }
 };
 
 CoreSampler::CoreSampler()
 : currentSampleRate(44100.0f)    // sensible guess
+, data(new InternalData)
 , isKeyMapValid(false)
 , isFilterEnabled(false)
 , restartVoiceLFO(false)
+, filterType(0)
+, isAmpEnvelopeAudioRate(false)
 , masterVolume(1.0f)
 , pitchOffset(0.0f)
 , vibratoDepth(0.0f)
@@ -63,20 +78,19 @@ CoreSampler::CoreSampler()
 , pitchADSRSemitones(0.0f)
 , loopThruRelease(false)
 , stoppingAllVoices(false)
-, data(new InternalData)
 {
     DunneCore::SamplerVoice *pVoice = data->voice;
     for (int i=0; i < MAX_POLYPHONY; i++, pVoice++)
     {
-        pVoice->ampEnvelope.pParameters = &data->ampEnvelopeParameters;
-        pVoice->filterEnvelope.pParameters = &data->filterEnvelopeParameters;
-        pVoice->pitchEnvelope.pParameters = &data->pitchEnvelopeParameters;
+        pVoice->ampEnvelope.pParameters = &data->ampEnvelopeParameters.live;
+        pVoice->filterEnvelope.pParameters = &data->filterEnvelopeParameters.live;
+        pVoice->pitchEnvelope.pParameters = &data->pitchEnvelopeParameters.live;
         pVoice->noteFrequency = 0.0f;
         pVoice->glideSecPerOctave = &glideRate;
     }
     
     for (int i=0; i < 128; i++)
-        data->tuningTable[i] = NOTE_HZ(i);
+        data->tuningTable[i] = DunneCore::noteFrequencyTable[i];
 }
 
 CoreSampler::~CoreSampler()
@@ -87,11 +101,11 @@ CoreSampler::~CoreSampler()
 int CoreSampler::init(double sampleRate)
 {
     currentSampleRate = (float)sampleRate;
-    data->ampEnvelopeParameters.updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
-    data->filterEnvelopeParameters.updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
-    data->pitchEnvelopeParameters.updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
-    data->vibratoLFO.waveTable.sinusoid();
-    data->vibratoLFO.init(sampleRate/CORESAMPLER_CHUNKSIZE, 5.0f);
+    data->ampEnvelopeParameters.edit()->updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
+    data->filterEnvelopeParameters.edit()->updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
+    data->pitchEnvelopeParameters.edit()->updateSampleRate((float)(sampleRate/CORESAMPLER_CHUNKSIZE));
+    data->applyParameterChanges();
+    data->vibratoLFO.init(DunneCore::sineTable.values, DunneCore::sineTableSize, sampleRate/CORESAMPLER_CHUNKSIZE, 5.0f);
     
     for (int i=0; i<MAX_POLYPHONY; i++)
         data->voice[i].init(sampleRate);
@@ -253,6 +267,7 @@ DunneCore::SamplerVoice *CoreSampler::voicePlayingNote(unsigned noteNumber)
 
 void CoreSampler::playNote(unsigned noteNumber, unsigned velocity)
 {
+    data->applyParameterChanges();
     bool anotherKeyWasDown = data->pedalLogic.isAnyKeyDown();
     data->pedalLogic.keyDownAction(noteNumber);
     play(noteNumber, velocity, anotherKeyWasDown);
@@ -406,17 +421,22 @@ void CoreSampler::restartVoices()
 void CoreSampler::render(unsigned channelCount, unsigned sampleCount, float *outBuffers[])
 {
     float *pOutLeft = outBuffers[0];
-    float *pOutRight = outBuffers[1];
+    float *pOutRight = channelCount > 1 ? outBuffers[1] : NULL;   // NULL: mono output
+    data->applyParameterChanges();
     data->vibratoLFO.setFrequency(vibratoFrequency);
     float pitchDev = this->pitchOffset + vibratoDepth * data->vibratoLFO.getSample();
     float cutoffMul = isFilterEnabled ? cutoffMultiple : -1.0f;
     
     bool allowSampleRunout = !(isMonophonic && isLegato);
+    int voiceFilterType = filterType == DunneCore::VoiceFilter::kStateVariable
+                        ? DunneCore::VoiceFilter::kStateVariable : DunneCore::VoiceFilter::kResonantLowPass;
 
     DunneCore::SamplerVoice *pVoice = &data->voice[0];
     for (int i=0; i < MAX_POLYPHONY; i++, pVoice++)
     {
         pVoice->restartVoiceLFO = restartVoiceLFO;
+        pVoice->filter.setType(voiceFilterType);
+        pVoice->isAmpEnvelopeAudioRate = isAmpEnvelopeAudioRate;
         int nn = pVoice->noteNumber;
         if (nn >= 0)
         {
@@ -432,157 +452,171 @@ void CoreSampler::render(unsigned channelCount, unsigned sampleCount, float *out
     }
 }
 
-void  CoreSampler::setADSRAttackDurationSeconds(float value) __attribute__((no_sanitize("thread")))
+void  CoreSampler::setADSRAttackDurationSeconds(float value)
 {
-    data->ampEnvelopeParameters.setAttackDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->setAttackDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRAttackDurationSeconds(void)
 {
-    return data->ampEnvelopeParameters.getAttackDurationSeconds();
+    return data->ampEnvelopeParameters.read()->getAttackDurationSeconds();
 }
 
 void  CoreSampler::setADSRHoldDurationSeconds(float value)
 {
-    data->ampEnvelopeParameters.setHoldDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->setHoldDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRHoldDurationSeconds(void)
 {
-    return data->ampEnvelopeParameters.getHoldDurationSeconds();
+    return data->ampEnvelopeParameters.read()->getHoldDurationSeconds();
 }
 
 void  CoreSampler::setADSRDecayDurationSeconds(float value)
 {
-    data->ampEnvelopeParameters.setDecayDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->setDecayDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRDecayDurationSeconds(void)
 {
-    return data->ampEnvelopeParameters.getDecayDurationSeconds();
+    return data->ampEnvelopeParameters.read()->getDecayDurationSeconds();
 }
 
 void  CoreSampler::setADSRSustainFraction(float value)
 {
-    data->ampEnvelopeParameters.sustainFraction = value;
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->sustainFraction = value;
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRSustainFraction(void)
 {
-    return data->ampEnvelopeParameters.sustainFraction;
+    return data->ampEnvelopeParameters.read()->sustainFraction;
 }
 
 void  CoreSampler::setADSRReleaseHoldDurationSeconds(float value)
 {
-    data->ampEnvelopeParameters.setReleaseHoldDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->setReleaseHoldDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRReleaseHoldDurationSeconds(void)
 {
-    return data->ampEnvelopeParameters.getReleaseHoldDurationSeconds();
+    return data->ampEnvelopeParameters.read()->getReleaseHoldDurationSeconds();
 }
 
 void  CoreSampler::setADSRReleaseDurationSeconds(float value)
 {
-    data->ampEnvelopeParameters.setReleaseDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateAmpAdsrParameters();
+    auto pParameters = data->ampEnvelopeParameters.edit();
+    pParameters->setReleaseDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getADSRReleaseDurationSeconds(void)
 {
-    return data->ampEnvelopeParameters.getReleaseDurationSeconds();
+    return data->ampEnvelopeParameters.read()->getReleaseDurationSeconds();
 }
 
 void  CoreSampler::setFilterAttackDurationSeconds(float value)
 {
-    data->filterEnvelopeParameters.setAttackDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateFilterAdsrParameters();
+    auto pParameters = data->filterEnvelopeParameters.edit();
+    pParameters->setAttackDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getFilterAttackDurationSeconds(void)
 {
-    return data->filterEnvelopeParameters.getAttackDurationSeconds();
+    return data->filterEnvelopeParameters.read()->getAttackDurationSeconds();
 }
 
 void  CoreSampler::setFilterDecayDurationSeconds(float value)
 {
-    data->filterEnvelopeParameters.setDecayDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateFilterAdsrParameters();
+    auto pParameters = data->filterEnvelopeParameters.edit();
+    pParameters->setDecayDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getFilterDecayDurationSeconds(void)
 {
-    return data->filterEnvelopeParameters.getDecayDurationSeconds();
+    return data->filterEnvelopeParameters.read()->getDecayDurationSeconds();
 }
 
 void  CoreSampler::setFilterSustainFraction(float value)
 {
-    data->filterEnvelopeParameters.sustainFraction = value;
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateFilterAdsrParameters();
+    auto pParameters = data->filterEnvelopeParameters.edit();
+    pParameters->sustainFraction = value;
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getFilterSustainFraction(void)
 {
-    return data->filterEnvelopeParameters.sustainFraction;
+    return data->filterEnvelopeParameters.read()->sustainFraction;
 }
 
 void  CoreSampler::setFilterReleaseDurationSeconds(float value)
 {
-    data->filterEnvelopeParameters.setReleaseDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updateFilterAdsrParameters();
+    auto pParameters = data->filterEnvelopeParameters.edit();
+    pParameters->setReleaseDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getFilterReleaseDurationSeconds(void)
 {
-    return data->filterEnvelopeParameters.getReleaseDurationSeconds();
+    return data->filterEnvelopeParameters.read()->getReleaseDurationSeconds();
 }
 
 
 void  CoreSampler::setPitchAttackDurationSeconds(float value)
 {
-    data->pitchEnvelopeParameters.setAttackDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updatePitchAdsrParameters();
+    auto pParameters = data->pitchEnvelopeParameters.edit();
+    pParameters->setAttackDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getPitchAttackDurationSeconds(void)
 {
-    return data->pitchEnvelopeParameters.getAttackDurationSeconds();
+    return data->pitchEnvelopeParameters.read()->getAttackDurationSeconds();
 }
 
 void  CoreSampler::setPitchDecayDurationSeconds(float value)
 {
-    data->pitchEnvelopeParameters.setDecayDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updatePitchAdsrParameters();
+    auto pParameters = data->pitchEnvelopeParameters.edit();
+    pParameters->setDecayDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getPitchDecayDurationSeconds(void)
 {
-    return data->pitchEnvelopeParameters.getDecayDurationSeconds();
+    return data->pitchEnvelopeParameters.read()->getDecayDurationSeconds();
 }
 
 void  CoreSampler::setPitchSustainFraction(float value)
 {
-    data->pitchEnvelopeParameters.sustainFraction = value;
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updatePitchAdsrParameters();
+    auto pParameters = data->pitchEnvelopeParameters.edit();
+    pParameters->sustainFraction = value;
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getPitchSustainFraction(void)
 {
-    return data->pitchEnvelopeParameters.sustainFraction;
+    return data->pitchEnvelopeParameters.read()->sustainFraction;
 }
 
 void  CoreSampler::setPitchReleaseDurationSeconds(float value)
 {
-    data->pitchEnvelopeParameters.setReleaseDurationSeconds(value);
-    for (int i = 0; i < MAX_POLYPHONY; i++) data->voice[i].updatePitchAdsrParameters();
+    auto pParameters = data->pitchEnvelopeParameters.edit();
+    pParameters->setReleaseDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSampler::getPitchReleaseDurationSeconds(void)
 {
-    return data->pitchEnvelopeParameters.getReleaseDurationSeconds();
+    return data->pitchEnvelopeParameters.read()->getReleaseDurationSeconds();
 }
@@ -58,6 +58,8 @@ public:
     void stopNote(unsigned noteNumber, bool immediate);
     void sustainPedal(bool down);
     
+    // add sampleCount samples to outBuffers[0] and outBuffers[1]; if channelCount is 1, only
+    // outBuffers[0] is used, and gets a mono mix, with each voice filtered as a single channel
     void render(unsigned channelCount, unsigned sampleCount, float *outBuffers[]);
 
     void  setADSRAttackDurationSeconds(float value);
@@ -104,6 +106,15 @@ public:
     
     // simple parameters
     bool isFilterEnabled, restartVoiceLFO;
+
+    /// per-voice filter type: 0 = resonant low-pass (default), 1 = state-variable (see
+    /// DunneCore::VoiceFilter). The ladder is not offered here: one voice's costs about three times
+    /// the default filter's, so it and any other value select the resonant low-pass.
+    int filterType;
+
+    /// if true, the amp envelope runs at audio rate rather than once per chunk, for exact,
+    /// click-free fast attacks, at the cost of one block envelope evaluation per voice per chunk
+    bool isAmpEnvelopeAudioRate;
     
     // performance parameters
     float masterVolume, pitchOffset, vibratoDepth, vibratoFrequency,
@@ -64,6 +64,16 @@ namespace DunneCore
             sj = rj < sampleCount ? samples[sampleCount + rj] : 0.0f;
             *rightOutput = (float)(gain * ((1.0f - f) * si + f * sj));
         }
+
+        // interp() of one channel, without its checks, for an index known to be in range:
+        // int(fIndex) + 1 < sampleCount (see SampleOscillator::getSamples())
+        inline float interpInRange(double fIndex, int channel, float gain) const
+        {
+            const float *channelSamples = samples + channel * sampleCount;
+            int ri = int(fIndex);
+            double f = fIndex - ri;
+            return (float)(gain * ((1.0 - f) * channelSamples[ri] + f * channelSamples[ri + 1]));
+        }
     };
     
     // KeyMappedSampleBuffer is a derived version with added MIDI note-number and velocity ranges
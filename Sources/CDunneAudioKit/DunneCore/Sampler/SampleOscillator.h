@@ -4,6 +4,7 @@
 #include <math.h>
 
 #include "SampleBuffer.h"
+#include "FastMath.h"
 
 namespace DunneCore
 {
@@ -15,7 +16,7 @@ namespace DunneCore
         double increment;   // 1.0 = play at original speed
         double multiplier;  // multiplier applied to increment for pitch bend, vibrato
         
-        void setPitchOffsetSemitones(double semitones) { multiplier = pow(2.0, semitones/12.0); }
+        void setPitchOffsetSemitones(double semitones) { multiplier = fastSemitonesToRatio(float(semitones)); }
         
         // return true if we run out of samples
         inline bool getSample(SampleBuffer *sampleBuffer, int sampleCount, float *output, float gain)
@@ -46,6 +47,47 @@ namespace DunneCore
             }
             return false;
         }
+
+        // Render up to count samples into pLeft and, for a stereo source, pRight, scaling the ith
+        // by gains[i]; a mono source writes pLeft only. isStereo and isLoop must match sampleBuffer
+        // (2 channels; isLooping and still this->isLooping), so each combination compiles to its
+        // own loop. Within a chunk, the samples which cannot reach the end point, the loop end or
+        // the end of the data are rendered with no tests at all; only those near a boundary go
+        // through the checks of getSamplePair(). Returns the number rendered, which is less than
+        // count only if the sample has run out.
+        template<bool isStereo, bool isLoop>
+        inline int getSamples(SampleBuffer *sampleBuffer, const float *gains, float *pLeft, float *pRight, int count)
+        {
+            double step = multiplier * increment;
+            int n = 0;
+            while (n < count)
+            {
+                // steps which keep indexPoint below all the boundaries, less one for rounding
+                double limit = sampleBuffer->sampleCount - 2;
+                if (sampleBuffer->endPoint < limit) limit = sampleBuffer->endPoint;
+                if (isLoop && sampleBuffer->loopEndPoint < limit) limit = sampleBuffer->loopEndPoint;
+                double safeSteps = step > 0.0 && sampleBuffer->samples ? (limit - indexPoint) / step - 1.0 : 0.0;
+                int safeCount = safeSteps < count - n ? (safeSteps > 0.0 ? int(safeSteps) : 0) : count - n;
+
+                for (int i=0; i < safeCount; i++, n++)
+                {
+                    pLeft[n] = sampleBuffer->interpInRange(indexPoint, 0, gains[n]);
+                    if (isStereo) pRight[n] = sampleBuffer->interpInRange(indexPoint, 1, gains[n]);
+                    indexPoint += step;
+                }
+                if (n == count) break;
+
+                // one sample with all the checks
+                if (indexPoint > sampleBuffer->endPoint) break;
+                if (isStereo) sampleBuffer->interp(indexPoint, &pLeft[n], &pRight[n], gains[n]);
+                else pLeft[n] = sampleBuffer->interp(indexPoint, gains[n]);
+                indexPoint += step;
+                if (isLoop && indexPoint > sampleBuffer->loopEndPoint)
+                    indexPoint = indexPoint - sampleBuffer->loopEndPoint + sampleBuffer->loopStartPoint;
+                n++;
+            }
+            return n;
+        }
     };
 
 }
@@ -1,6 +1,8 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "SamplerVoice.h"
+#include "FastMath.h"
+#include "LookupTables.h"
 #include <stdio.h>
 
 #define MIDDLE_C_HZ 262.626f
@@ -10,15 +12,16 @@ namespace DunneCore
     void SamplerVoice::init(double sampleRate)
     {
         samplingRate = float(sampleRate);
-        leftFilter.init(sampleRate);
-        rightFilter.init(sampleRate);
+        filter.init(sampleRate);
+        filter.setStages(1);
         ampEnvelope.init();
         filterEnvelope.init();
         pitchEnvelope.init();
-        vibratoLFO.waveTable.sinusoid();
-        vibratoLFO.init(sampleRate/CORESAMPLER_CHUNKSIZE, 5.0f);
+        vibratoLFO.init(sineTable.values, sineTableSize, sampleRate/CORESAMPLER_CHUNKSIZE, 5.0f);
         restartVoiceLFO = false;
+        isPitchDirty = true;
         volumeRamper.init(0.0f);
+        isAmpEnvelopeAudioRate = false;
         tempGain = 0.0f;
     }
 
@@ -35,8 +38,7 @@ namespace DunneCore
         volumeRamper.init(0.0f);
         
         samplingRate = sampleRate;
-        leftFilter.updateSampleRate(double(samplingRate));
-        rightFilter.updateSampleRate(double(samplingRate));
+        filter.updateSampleRate(double(samplingRate));
         filterEnvelope.start();
 
         pitchEnvelope.start();
@@ -49,11 +51,12 @@ namespace DunneCore
         if (*glideSecPerOctave != 0.0f && noteFrequency != 0.0 && noteFrequency != frequency)
         {
             // prepare to glide
-            glideSemitones = -12.0f * log2f(frequency / noteFrequency);
+            glideSemitones = -fastRatioToSemitones(frequency / noteFrequency);
             if (fabsf(glideSemitones) < 0.01f) glideSemitones = 0.0f;
         }
         noteFrequency = frequency;
         noteNumber = note;
+        isPitchDirty = true;
 
         restartVoiceLFOIfNeeded();
     }
@@ -61,15 +64,14 @@ namespace DunneCore
     void SamplerVoice::restartNewNote(unsigned note, float sampleRate, float frequency, float volume, SampleBuffer *buffer)
     {
         samplingRate = sampleRate;
-        leftFilter.updateSampleRate(double(samplingRate));
-        rightFilter.updateSampleRate(double(samplingRate));
+        filter.updateSampleRate(double(samplingRate));
 
         oscillator.increment = (sampleBuffer->sampleRate / sampleRate) * (frequency / sampleBuffer->noteFrequency);
         glideSemitones = 0.0f;
         if (*glideSecPerOctave != 0.0f && noteFrequency != 0.0 && noteFrequency != frequency)
         {
             // prepare to glide
-            glideSemitones = -12.0f * log2f(frequency / noteFrequency);
+            glideSemitones = -fastRatioToSemitones(frequency / noteFrequency);
             if (fabsf(glideSemitones) < 0.01f) glideSemitones = 0.0f;
         }
 
@@ -79,6 +81,7 @@ namespace DunneCore
 
         noteFrequency = frequency;
         noteNumber = note;
+        isPitchDirty = true;
         tempNoteVolume = noteVolume;
         newSampleBuffer = buffer;
         ampEnvelope.restart();
@@ -91,19 +94,19 @@ namespace DunneCore
     void SamplerVoice::restartNewNoteLegato(unsigned note, float sampleRate, float frequency)
     {
         samplingRate = sampleRate;
-        leftFilter.updateSampleRate(double(samplingRate));
-        rightFilter.updateSampleRate(double(samplingRate));
+        filter.updateSampleRate(double(samplingRate));
 
         oscillator.increment = (sampleBuffer->sampleRate / sampleRate) * (frequency / sampleBuffer->noteFrequency);
         glideSemitones = 0.0f;
         if (*glideSecPerOctave != 0.0f && noteFrequency != 0.0 && noteFrequency != frequency)
         {
             // prepare to glide
-            glideSemitones = -12.0f * log2f(frequency / noteFrequency);
+            glideSemitones = -fastRatioToSemitones(frequency / noteFrequency);
             if (fabsf(glideSemitones) < 0.01f) glideSemitones = 0.0f;
         }
         noteFrequency = frequency;
         noteNumber = note;
+        isPitchDirty = true;
     }
 
     void SamplerVoice::restartSameNote(float volume, SampleBuffer *buffer)
@@ -145,13 +148,13 @@ namespace DunneCore
         if (ampEnvelope.isPreStarting())
         {
             tempGain = masterVolume * tempNoteVolume;
-            volumeRamper.reinit(ampEnvelope.getSample(), sampleCount);
+            advanceAmpEnvelope(sampleCount);
             // This can execute as part of the voice-stealing mechanism, and will be executed rarely.
             // To test, set MAX_POLYPHONY in CoreSampler.cpp to something small like 2 or 3.
             if (!ampEnvelope.isPreStarting())
             {
                 tempGain = masterVolume * noteVolume;
-                volumeRamper.reinit(ampEnvelope.getSample(), sampleCount);
+                advanceAmpEnvelope(sampleCount);
                 sampleBuffer = newSampleBuffer;
                 oscillator.increment = (sampleBuffer->sampleRate / samplingRate) * (noteFrequency / sampleBuffer->noteFrequency);
                 oscillator.indexPoint = sampleBuffer->startPoint;
@@ -161,7 +164,7 @@ namespace DunneCore
         else
         {
             tempGain = masterVolume * noteVolume;
-            volumeRamper.reinit(ampEnvelope.getSample(), sampleCount);
+            advanceAmpEnvelope(sampleCount);
         }
 
         if (*glideSecPerOctave != 0.0f && glideSemitones != 0.0f)
@@ -180,15 +183,37 @@ namespace DunneCore
             }
         }
 
+        // Pitch modulation sources only do their sums while they have some effect, and the exp2()s
+        // which turn the total into oscillator and filter frequencies only run when it changes,
+        // so a sustained voice without glide, pitch envelope or vibrato costs very little here.
         float pitchCurveAmount = 1.0f; // >1 = faster curve, 0 < curve < 1 = slower curve - make this a parameter
         if (pitchCurveAmount < 0) { pitchCurveAmount = 0; }
-        pitchEnvelopeSemitones = pow(pitchEnvelope.getSample(), pitchCurveAmount) * pitchADSRSemitones;
+        float pitchEnvelopeValue = pitchEnvelope.getSample();
+        pitchEnvelopeSemitones = 0.0f;
+        if (pitchADSRSemitones != 0.0f)
+        {
+            // a linear curve is the envelope value itself; only bend it when the curve asks for it
+            float curvedValue = pitchEnvelopeValue;
+            if (pitchCurveAmount != 1.0f)
+                curvedValue = pitchEnvelopeValue > 0.0f ? fastExp2(pitchCurveAmount * fastLog2(pitchEnvelopeValue)) : 0.0f;
+            pitchEnvelopeSemitones = curvedValue * pitchADSRSemitones;
+        }
 
         vibratoLFO.setFrequency(voiceLFOFrequencyHz);
-        voiceLFOSemitones = vibratoLFO.getSample() * voiceLFODepthSemitones;
+        voiceLFOSemitones = 0.0f;
+        if (voiceLFODepthSemitones != 0.0f)
+            voiceLFOSemitones = vibratoLFO.getSample() * voiceLFODepthSemitones;
+        else
+            vibratoLFO.advance();
 
         float pitchOffsetModified = pitchOffset + glideSemitones + pitchEnvelopeSemitones + voiceLFOSemitones;
-        oscillator.setPitchOffsetSemitones(pitchOffsetModified);
+        if (isPitchDirty || pitchOffsetModified != pitchOffsetSemitones)
+        {
+            oscillator.setPitchOffsetSemitones(pitchOffsetModified);
+            pitchedNoteHz = noteFrequency * float(oscillator.multiplier);
+            pitchOffsetSemitones = pitchOffsetModified;
+            isPitchDirty = false;
+        }
 
         // negative value of cutoffMultiple means filters are disabled
         if (cutoffMultiple < 0.0f)
@@ -198,12 +223,10 @@ namespace DunneCore
         else
         {
             isFilterEnabled = true;
-            float noteHz = noteFrequency * powf(2.0f, (pitchOffsetModified) / 12.0f);
-            float baseFrequency = MIDDLE_C_HZ + keyTracking * (noteHz - MIDDLE_C_HZ);
+            float baseFrequency = MIDDLE_C_HZ + keyTracking * (pitchedNoteHz - MIDDLE_C_HZ);
             float envStrength = ((1.0f - cutoffEnvelopeVelocityScaling) + cutoffEnvelopeVelocityScaling * noteVolume);
             double cutoffFrequency = baseFrequency * (1.0f + cutoffMultiple + cutoffEnvelopeStrength * envStrength * filterEnvelope.getSample());
-            leftFilter.setParameters(cutoffFrequency, resLinear);
-            rightFilter.setParameters(cutoffFrequency, resLinear);
+            filter.setParameters(cutoffFrequency, resLinear);
         }
         
         return false;
@@ -211,26 +234,110 @@ namespace DunneCore
     
     bool SamplerVoice::getSamples(int sampleCount, float *leftOutput, float *rightOutput)
     {
-        for (int i=0; i < sampleCount; i++)
+        if (sampleBuffer == NULL) return sampleCount > 0;
+
+        // choose the render loop once per call, rather than testing these for every sample;
+        // the table is indexed by the template arguments' bits, in order
+        typedef bool (SamplerVoice::*RenderFunction)(int, float *, float *);
+        static const RenderFunction renderFunctions[16] =
+        {
+            &SamplerVoice::renderChunks<false, false, false, false>, &SamplerVoice::renderChunks<false, false, false, true>,
+            &SamplerVoice::renderChunks<false, false, true, false>, &SamplerVoice::renderChunks<false, false, true, true>,
+            &SamplerVoice::renderChunks<false, true, false, false>, &SamplerVoice::renderChunks<false, true, false, true>,
+            &SamplerVoice::renderChunks<false, true, true, false>, &SamplerVoice::renderChunks<false, true, true, true>,
+            &SamplerVoice::renderChunks<true, false, false, false>, &SamplerVoice::renderChunks<true, false, false, true>,
+            &SamplerVoice::renderChunks<true, false, true, false>, &SamplerVoice::renderChunks<true, false, true, true>,
+            &SamplerVoice::renderChunks<true, true, false, false>, &SamplerVoice::renderChunks<true, true, false, true>,
+            &SamplerVoice::renderChunks<true, true, true, false>, &SamplerVoice::renderChunks<true, true, true, true>,
+        };
+        bool isStereoSource = sampleBuffer->channelCount != 1;
+        bool isLoopingSample = sampleBuffer->isLooping && oscillator.isLooping;
+        bool isMonoOutput = rightOutput == NULL;
+        int index = (isStereoSource ? 8 : 0) + (isLoopingSample ? 4 : 0) + (isFilterEnabled ? 2 : 0) + (isMonoOutput ? 1 : 0);
+        return (this->*renderFunctions[index])(sampleCount, leftOutput, rightOutput);
+    }
+
+    template<bool isStereoSource, bool isLoopingSample, bool isFiltered, bool isMonoOutput>
+    bool SamplerVoice::renderChunks(int sampleCount, float *leftOutput, float *rightOutput)
+    {
+        // A mono source, or any source into a mono output, is filtered as one channel, and only
+        // split into left and right (or not at all) as it is added to the output.
+        constexpr bool isStereoVoice = isStereoSource && !isMonoOutput;
+
+        // the filter works on whole chunks, so the oscillator output is collected first
+        float gains[CORESAMPLER_CHUNKSIZE];
+        float leftSamples[CORESAMPLER_CHUNKSIZE], rightSamples[CORESAMPLER_CHUNKSIZE];
+
+        for (int offset=0; offset < sampleCount; offset += CORESAMPLER_CHUNKSIZE)
         {
-            float gain = tempGain * volumeRamper.getNextValue();
-            float leftSample, rightSample;
-            if (oscillator.getSamplePair(sampleBuffer, sampleCount, &leftSample, &rightSample, gain))
-                return true;
-            if (isFilterEnabled)
+            int count = sampleCount - offset;
+            if (count > CORESAMPLER_CHUNKSIZE) count = CORESAMPLER_CHUNKSIZE;
+
+            getAmpGains(offset, count, gains);
+            int rendered = oscillator.getSamples<isStereoSource, isLoopingSample>(sampleBuffer, gains,
+                                                                                  leftSamples, rightSamples, count);
+            if (isStereoSource && isMonoOutput)
+                for (int i=0; i < rendered; i++) leftSamples[i] = 0.5f * (leftSamples[i] + rightSamples[i]);
+
+            if (isFiltered)
             {
-                *leftOutput++ += leftFilter.process(leftSample);
-                *rightOutput++ += rightFilter.process(rightSample);
+                if (isStereoVoice) filter.process(leftSamples, rightSamples, rendered);
+                else filter.processMono(leftSamples, rendered);
+            }
+
+            if (isMonoOutput)
+            {
+                for (int i=0; i < rendered; i++) leftOutput[i] += leftSamples[i];
             }
             else
             {
-                *leftOutput++ += leftSample;
-                *rightOutput++ += rightSample;
+                const float *pRight = isStereoVoice ? rightSamples : leftSamples;
+                for (int i=0; i < rendered; i++)
+                {
+                    leftOutput[i] += leftSamples[i];
+                    rightOutput[i] += pRight[i];
+                }
+                rightOutput += rendered;
             }
+            leftOutput += rendered;
+            if (rendered < count) return true;
         }
         return false;
     }
 
+    void SamplerVoice::getAmpGains(int offset, int count, float *gains)
+    {
+        if (isAmpEnvelopeAudioRate)
+        {
+            // past the first chunk, hold the last envelope value (see advanceAmpEnvelope())
+            for (int i=0; i < count; i++)
+                gains[i] = tempGain * ampEnvelopeValues[offset == 0 ? i : CORESAMPLER_CHUNKSIZE - 1];
+        }
+        else
+        {
+            for (int i=0; i < count; i++) gains[i] = tempGain * volumeRamper.getNextValue();
+        }
+    }
+
+    void SamplerVoice::advanceAmpEnvelope(int sampleCount)
+    {
+        if (isAmpEnvelopeAudioRate)
+        {
+            // each envelope step lasts one chunk; render() is never given more than one chunk at a
+            // time, and should it be, getSamples() holds the last value past the first chunk
+            int count = sampleCount < CORESAMPLER_CHUNKSIZE ? sampleCount : CORESAMPLER_CHUNKSIZE;
+            if (count < 1) return;
+            ampEnvelope.getSamples(ampEnvelopeValues, count, 1.0 / CORESAMPLER_CHUNKSIZE);
+
+            // so the ramp carries on from here, if switched back to control rate
+            volumeRamper.init(ampEnvelopeValues[count - 1]);
+        }
+        else
+        {
+            volumeRamper.reinit(ampEnvelope.getSample(), sampleCount);
+        }
+    }
+
     void SamplerVoice::restartVoiceLFOIfNeeded() {
         if (restartVoiceLFO || !hasStartedVoiceLFO) {
             vibratoLFO.phase = 0;
@@ -8,7 +8,7 @@
 #include "ADSREnvelope.h"
 #include "AHDSHREnvelope.h"
 #include "FunctionTable.h"
-#include "ResonantLowPassFilter.h"
+#include "VoiceFilter.h"
 #include "LinearRamper.h"
 
 // process samples in "chunks" this size
@@ -26,13 +26,13 @@ namespace DunneCore
         /// a pointer to the sample buffer for that oscillator
         SampleBuffer *sampleBuffer;
 
-        /// two filters (left/right)
-        ResonantLowPassFilter leftFilter, rightFilter;
+        /// stereo filter, a single stage of the selected type; mono sources filter one channel only
+        VoiceFilter filter;
         AHDSHREnvelope ampEnvelope;
         ADSREnvelope filterEnvelope, pitchEnvelope;
 
-        // per-voice vibrato LFO
-        FunctionTableOscillator vibratoLFO;
+        // per-voice vibrato LFO, reading sineTable (see LookupTables.h)
+        SharedFunctionTableOscillator vibratoLFO;
 
         // restart phase of per-voice vibrato LFO
         bool restartVoiceLFO;
@@ -55,6 +55,11 @@ namespace DunneCore
         /// amount of semitone change via voice lfo
         float voiceLFOSemitones;
 
+        /// total pitch offset last applied to oscillator, and the resulting note frequency in Hz;
+        /// recomputed only when the offset changes, or after isPitchDirty is set by a new note
+        float pitchOffsetSemitones, pitchedNoteHz;
+        bool isPitchDirty;
+
         /// fraction 0.0 - 1.0, based on MIDI velocity
         float noteVolume;
 
@@ -72,16 +77,16 @@ namespace DunneCore
         /// ramper to smooth subsampled output of adsrEnvelope
         LinearRamper volumeRamper;
 
+        /// if true, ampEnvelope runs at audio rate, into ampEnvelopeValues, instead of volumeRamper
+        bool isAmpEnvelopeAudioRate;
+        float ampEnvelopeValues[CORESAMPLER_CHUNKSIZE];
+
         /// true if filter should be used
         bool isFilterEnabled;
         
         SamplerVoice() : noteNumber(-1) {}
 
         void init(double sampleRate);
-
-        void updateAmpAdsrParameters() { ampEnvelope.updateParams(); }
-        void updateFilterAdsrParameters() { filterEnvelope.updateParams(); }
-        void updatePitchAdsrParameters() { pitchEnvelope.updateParams(); }
         
         void start(unsigned noteNumber,
                    float sampleRate,
@@ -107,11 +112,23 @@ namespace DunneCore
                               float voiceLFOFrequencyHz,
                               float voiceLFODepthSemitones);
 
+        // add sampleCount samples to leftOutput and rightOutput, or, if rightOutput is NULL, a mono
+        // mix of them to leftOutput alone; return true if the sample has run out
         bool getSamples(int sampleCount, float *leftOutput, float *rightOutput);
 
     private:
         bool hasStartedVoiceLFO;
         void restartVoiceLFOIfNeeded();
+
+        // next sampleCount samples' worth of ampEnvelope
+        void advanceAmpEnvelope(int sampleCount);
+
+        // getSamples() for one combination of source channels, looping, filtering and output channels
+        template<bool isStereoSource, bool isLoopingSample, bool isFiltered, bool isMonoOutput>
+        bool renderChunks(int sampleCount, float *leftOutput, float *rightOutput);
+
+        // tempGain times the amp envelope for count samples, starting offset samples into the call
+        void getAmpGains(int offset, int count, float *gains);
     };
 
 }
@@ -1,38 +1,127 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "CoreSynth.h"
+#include "FastMath.h"
+#include "ForkJoinPool.h"
 #include "FunctionTable.h"
+#include "LookupTables.h"
+#include "ModulationMatrix.h"
 #include "SynthVoice.h"
+#include "SynthVoiceBank.h"
 #include "WaveStack.h"
+#include "WavetableOscillator.h"
 #include "SustainPedalLogic.h"
+#include "VoiceAllocator.h"
+#include "ParameterSnapshot.h"
 
 #include <math.h>
+#include <algorithm>
+#include <atomic>
 #include <list>
-#include <random>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using std::unique_ptr;
 
-#define MAX_VOICE_COUNT 32      // number of voices
+#define DEFAULT_VOICE_COUNT 32  // number of voices, unless setVoiceCount() asks for another
+#define MAX_VOICE_COUNT 1024    // most voices setVoiceCount() allows
 #define MIDI_NOTENUMBERS 128    // MIDI offers 128 distinct note numbers
 
 struct CoreSynth::InternalData
 {
-    std::mt19937 gen{0};
+    /// seed of the voices' random streams (see DunneCore::CounterRandom)
+    uint32_t randomSeed = 0;
 
-    /// array of voice resources
-    unique_ptr<DunneCore::SynthVoice> voice[MAX_VOICE_COUNT];
+    /// number of voices the next init() allocates; see setVoiceCount()
+    int requestedVoiceCount = DEFAULT_VOICE_COUNT;
+
+    /// number of render threads the next init() starts; see setRenderThreadCount()
+    int requestedRenderThreadCount = 1;
+
+    /// voice resources, in one contiguous block
+    std::vector<DunneCore::SynthVoice> voices;
+
+    /// which voices are free, held or releasing, for starting and stealing notes
+    DunneCore::VoiceAllocator voiceAllocator;
+
+    /// the voice most recently given each MIDI note number, or -1; see noteChanged()
+    int voiceForNote[MIDI_NOTENUMBERS];
+
+    // keep voiceForNote up to date when voice's noteNumber changes from oldNote to newNote
+    // (either may be -1); oldNote still belongs to any later voice it was given to
+    void noteChanged(int voice, int oldNote, int newNote)
+    {
+        if (oldNote >= 0 && voiceForNote[oldNote] == voice) voiceForNote[oldNote] = -1;
+        if (newNote >= 0) voiceForNote[newNote] = voice;
+    }
+
+    /// gain and filter state of the voices, processed together: voice i is column
+    /// i % SynthVoiceBank::maxVoices of bank i / SynthVoiceBank::maxVoices
+    std::vector<DunneCore::SynthVoiceBank> voiceBanks;
+
+    /// for the current render() call, columns [0, bankVoiceCount[b]) of bank b include all its
+    /// sounding voices
+    std::vector<int> bankVoiceCount;
+
+    /// sounding voices of the current render() call, in voice order
+    std::vector<int> activeVoices;
+    int activeVoiceCount = 0;
+
+    /// runs the sounding voices' oscillators on several threads; see setRenderThreadCount()
+    DunneCore::ForkJoinPool renderPool;
+
+    // Oscillator output of each voice for the current chunk, when renderPool has workers. Each
+    // voice has rows of its own, rather than interleaved columns of a bank's input, so threads
+    // don't write to the same cache lines; render() copies them into voiceBanks afterwards.
+    struct VoiceOutput
+    {
+        float samples[2][DunneCore::SynthVoiceBank::maxChunkSize];
+    };
+    std::vector<VoiceOutput> voiceOutput;
+    int chunkSampleCount = 0;
+
+    // renderPool task: the oscillators of a contiguous share of activeVoices
+    static void renderOscillators(void *context, int taskIndex, int taskCount);
+
+    // (re)allocate everything sized by the number of voices; not on the render thread
+    void allocateVoices(int voiceCount);
     
-    DunneCore::WaveStack waveform1, waveform2, waveform3;      // WaveStacks are shared by all voice oscillators
-    DunneCore::FunctionTableOscillator vibratoLFO;             // one vibrato LFO shared by all voices
+    // WaveStacks are shared by all voice oscillators (and by all CoreSynth instances)
+    std::shared_ptr<const DunneCore::WaveStack> waveform1, waveform2, waveform3;
+
+    // The wavetable in use by render() is only ever replaced by render() itself. Tables are
+    // built by wavetableLoader and handed over via newWavetable; the table render() lets go of
+    // is parked in oldWavetable, so it is freed by the next loader rather than the audio thread.
+    std::shared_ptr<const DunneCore::Wavetable> wavetable, newWavetable, oldWavetable;
+    std::mutex wavetableMutex;
+    std::atomic<bool> isNewWavetableReady{false};
+    std::thread wavetableLoader;
+    DunneCore::SharedFunctionTableOscillator vibratoLFO;             // one vibrato LFO shared by all voices
     DunneCore::SustainPedalLogic pedalLogic;
     
     // simple parameters
     DunneCore::SynthVoiceParameters voiceParameters;
-    DunneCore::ADSREnvelopeParameters ampEGParameters;
-    DunneCore::ADSREnvelopeParameters filterEGParameters;
+    // envelope parameters: the setters may be called on any thread, and the render thread picks
+    // up their changes (see applyParameterChanges()) before starting notes or rendering
+    DunneCore::ParameterSnapshot<DunneCore::ADSREnvelopeParameters> ampEGParameters;
+    DunneCore::ParameterSnapshot<DunneCore::ADSREnvelopeParameters> filterEGParameters;
+    // modulation routes, compiled by the setters; voices run the live copy
+    DunneCore::ParameterSnapshot<DunneCore::ModulationMatrix> modulation;
+
+    /// frequency of each voice's own LFO, in Hz
+    float voiceLFOFrequency = 1.0f;
     
     DunneCore::EnvelopeSegmentParameters segParameters[8];
     DunneCore::EnvelopeParameters envParameters;
+
+    // render thread only
+    void applyParameterChanges()
+    {
+        ampEGParameters.apply();
+        filterEGParameters.apply();
+        modulation.apply();
+    }
 };
 
 CoreSynth::CoreSynth()
@@ -40,40 +129,60 @@ CoreSynth::CoreSynth()
 , masterVolume(1.0f)
 , pitchOffset(0.0f)
 , vibratoDepth(0.0f)
+, wavetablePosition(0.0f)
 , cutoffMultiple(4.0f)
 , cutoffEnvelopeStrength(20.0f)
 , linearResonance(1.0f)
 , data(new InternalData)
 {
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
+    data->allocateVoices(DEFAULT_VOICE_COUNT);
+}
+
+void CoreSynth::InternalData::allocateVoices(int voiceCount)
+{
+    const int bankSize = DunneCore::SynthVoiceBank::maxVoices;
+    voices = std::vector<DunneCore::SynthVoice>(voiceCount);
+    for (auto& voice : voices)
     {
-        data->voice[i] = unique_ptr<DunneCore::SynthVoice>(new DunneCore::SynthVoice(&data->gen));
-        data->voice[i]->ampEG.pParameters = &data->ampEGParameters;
-        data->voice[i]->filterEG.pParameters = &data->filterEGParameters;
+        voice.ampEG.pParameters = &ampEGParameters.live;
+        voice.filterEG.pParameters = &filterEGParameters.live;
+        voice.pModulation = &modulation.live;
     }
+    voiceAllocator.init(voiceCount);
+    std::fill(voiceForNote, voiceForNote + MIDI_NOTENUMBERS, -1);
+    voiceBanks = std::vector<DunneCore::SynthVoiceBank>((voiceCount + bankSize - 1) / bankSize);
+    bankVoiceCount.assign(voiceBanks.size(), 0);
+    activeVoices.assign(voiceCount, 0);
+    voiceOutput.resize(voiceCount);
 }
 
 CoreSynth::~CoreSynth()
 {
+    if (data->wavetableLoader.joinable()) data->wavetableLoader.join();
 }
 
 int CoreSynth::init(double sampleRate)
 {
-    DunneCore::FunctionTable waveform;
-    int length = 1 << DunneCore::WaveStack::maxBits;
-    waveform.init(length);
-    waveform.sawtooth(0.2f);
-    data->waveform1.initStack(waveform.waveTable);
-    waveform.square(0.4f, 0.01f);
-    data->waveform2.initStack(waveform.waveTable);
-    waveform.triangle(0.5f);
-    data->waveform3.initStack(waveform.waveTable);
+    // waveforms don't depend on sample rate, so they need only be set up on the first init()
+    if (!data->waveform1)
+    {
+        DunneCore::FunctionTable waveform;
+        int length = 1 << DunneCore::WaveStack::maxBits;
+        waveform.init(length);
+        waveform.sawtooth(0.2f);
+        data->waveform1 = DunneCore::WaveStack::getShared(waveform.waveTable);
+        waveform.square(0.4f, 0.01f);
+        data->waveform2 = DunneCore::WaveStack::getShared(waveform.waveTable);
+        waveform.triangle(0.5f);
+        data->waveform3 = DunneCore::WaveStack::getShared(waveform.waveTable);
+    }
     
-    data->ampEGParameters.updateSampleRate((float)(sampleRate/SYNTH_CHUNKSIZE));
-    data->filterEGParameters.updateSampleRate((float)(sampleRate/SYNTH_CHUNKSIZE));
+    data->ampEGParameters.edit()->updateSampleRate((float)(sampleRate/SYNTH_CHUNKSIZE));
+    data->filterEGParameters.edit()->updateSampleRate((float)(sampleRate/SYNTH_CHUNKSIZE));
+    data->applyParameterChanges();
     
-    data->vibratoLFO.waveTable.sinusoid();
-    data->vibratoLFO.init(sampleRate/SYNTH_CHUNKSIZE, 5.0f);
+    data->vibratoLFO.init(DunneCore::sineTable.values, DunneCore::sineTableSize, sampleRate/SYNTH_CHUNKSIZE, 5.0f);
+    data->voiceParameters.voiceLFOPhaseDelta = (float)(data->voiceLFOFrequency / (sampleRate/SYNTH_CHUNKSIZE));
     
     data->voiceParameters.osc1.phases = 4;
     data->voiceParameters.osc1.frequencySpread = 25.0f;
@@ -105,7 +214,11 @@ int CoreSynth::init(double sampleRate)
     data->voiceParameters.osc3.drawbars[15] = 0.0f;
     data->voiceParameters.osc3.mixLevel = 0.5f;
     
+    data->voiceParameters.osc4.position = wavetablePosition;
+    data->voiceParameters.osc4.mixLevel = 0.0f;
+
     data->voiceParameters.filterStages = 2;
+    data->voiceParameters.filterType = DunneCore::VoiceFilter::kResonantLowPass;
     
     data->segParameters[0].initialLevel = 0.0f;   // attack: ramp quickly to 0.2
     data->segParameters[0].finalLevel = 0.2f;
@@ -128,21 +241,74 @@ int CoreSynth::init(double sampleRate)
     
     data->envParameters.init((float)(sampleRate/SYNTH_CHUNKSIZE), 6, data->segParameters, 3, 0, 5);
     
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
+    if (int(data->voices.size()) != data->requestedVoiceCount) data->allocateVoices(data->requestedVoiceCount);
+    for (auto& bank : data->voiceBanks) bank.init(sampleRate);
+    for (int i=0; i < int(data->voices.size()); i++)
     {
-        data->voice[i]->init(sampleRate, &data->waveform1, &data->waveform2, &data->waveform3, &data->voiceParameters, &data->envParameters);
+        data->voices[i].setRandomStream(data->randomSeed, i);
+        data->voices[i].init(sampleRate, data->waveform1.get(), data->waveform2.get(), data->waveform3.get(),
+                             data->wavetable.get(), &data->voiceParameters, &data->envParameters);
     }
+    data->voiceAllocator.init(int(data->voices.size()));     // all voices are free again
+    std::fill(data->voiceForNote, data->voiceForNote + MIDI_NOTENUMBERS, -1);
+    data->renderPool.setThreadCount(data->requestedRenderThreadCount);
     
     return 0;   // no error
 }
 
 void CoreSynth::deinit()
 {
+    // no workers left waiting while there is nothing to render; the next init() restarts them
+    data->renderPool.setThreadCount(1);
+}
+
+void CoreSynth::setVoiceCount(int voiceCount)
+{
+    if (voiceCount < 1) voiceCount = 1;
+    if (voiceCount > MAX_VOICE_COUNT) voiceCount = MAX_VOICE_COUNT;
+    data->requestedVoiceCount = voiceCount;
+}
+
+int CoreSynth::getVoiceCount(void)
+{
+    return int(data->voices.size());
+}
+
+void CoreSynth::setRenderThreadCount(int threadCount)
+{
+    // render() may be running ForkJoinPool::run(), so leave the pool alone until init()
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > MAX_VOICE_COUNT) threadCount = MAX_VOICE_COUNT;
+    data->requestedRenderThreadCount = threadCount;
+}
+
+int CoreSynth::getRenderThreadCount(void)
+{
+    return data->renderPool.getThreadCount();
+}
+
+void CoreSynth::InternalData::renderOscillators(void *context, int taskIndex, int taskCount)
+{
+    auto data = static_cast<InternalData *>(context);
+    int begin = data->activeVoiceCount * taskIndex / taskCount;
+    int end = data->activeVoiceCount * (taskIndex + 1) / taskCount;
+    for (int n=begin; n < end; n++)
+    {
+        int i = data->activeVoices[n];
+        data->voices[i].getOscillatorSamples(data->chunkSampleCount,
+                                             data->voiceOutput[i].samples[0], data->voiceOutput[i].samples[1], 1);
+    }
+}
+
+void CoreSynth::setRandomSeed(unsigned seed)
+{
+    data->randomSeed = seed;
 }
 
 void CoreSynth::playNote(unsigned noteNumber, unsigned velocity, float noteFrequency)
 {
     eventCounter++;
+    data->applyParameterChanges();
     data->pedalLogic.keyDownAction(noteNumber);
     play(noteNumber, velocity, noteFrequency);
 }
@@ -170,181 +336,307 @@ void CoreSynth::sustainPedal(bool down)
 
 DunneCore::SynthVoice *CoreSynth::voicePlayingNote(unsigned noteNumber)
 {
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
-    {
-        if (data->voice[i]->noteNumber == noteNumber) return data->voice[i].get();
-    }
-    return 0;
+    if (noteNumber >= MIDI_NOTENUMBERS) return 0;
+    int v = data->voiceForNote[noteNumber];
+    return v < 0 ? 0 : &data->voices[v];
+}
+
+int CoreSynth::voiceIndex(DunneCore::SynthVoice *pVoice)
+{
+    return int(pVoice - data->voices.data());
 }
 
 void CoreSynth::play(unsigned noteNumber, unsigned velocity, float noteFrequency)
 {
-    // is any voice already playing this note?
+    DunneCore::VoiceAllocator& allocator = data->voiceAllocator;
+
+    // is any voice already playing this note? If it is still held, or there is no free voice to
+    // take the note instead, re-start it; otherwise let it finish its release
     DunneCore::SynthVoice *pVoice = voicePlayingNote(noteNumber);
-    if (pVoice)
+    int v = allocator.firstFree();
+    if (pVoice && (v < 0 || !pVoice->ampEG.isReleasing()))
     {
-        // re-start the note
         pVoice->restart(eventCounter, velocity / 127.0f);
+        allocator.moveTo(voiceIndex(pVoice), DunneCore::VoiceAllocator::kActive);
         return;
     }
     
-    // find a free voice (with noteNumber < 0) to play the note
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
+    // a free voice plays the note
+    if (v >= 0)
     {
-        auto pVoice = data->voice[i].get();
-        if (pVoice->noteNumber < 0)
-        {
-            // found a free voice: assign it to play this note
-            pVoice->start(eventCounter, noteNumber, noteFrequency, velocity / 127.0f);
-            return;
-        }
-    }
-    
-    // all oscillators in use: find "stalest" voice to steal
-    unsigned greatestDiffOfAll = 0;
-    DunneCore::SynthVoice *pStalestVoiceOfAll = 0;
-    unsigned greatestDiffInRelease = 0;
-    DunneCore::SynthVoice *pStalestVoiceInRelease = 0;
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
-    {
-        auto pVoice = data->voice[i].get();
-        unsigned diff = eventCounter - pVoice->event;
-        if (pVoice->ampEG.isReleasing())
-        {
-            if (diff > greatestDiffInRelease)
-            {
-                greatestDiffInRelease = diff;
-                pStalestVoiceInRelease = pVoice;
-            }
-        }
-        if (diff > greatestDiffOfAll)
-        {
-            greatestDiffOfAll = diff;
-            pStalestVoiceOfAll = pVoice;
-        }
+        data->voices[v].start(eventCounter, noteNumber, noteFrequency, velocity / 127.0f);
+        data->noteChanged(v, -1, noteNumber);
+        allocator.moveTo(v, DunneCore::VoiceAllocator::kActive);
+        return;
     }
     
-    if (pStalestVoiceInRelease != 0)
-    {
-        // We have a stalest note in its release phase: restart that one
-        pStalestVoiceInRelease->restart(eventCounter, noteNumber, noteFrequency, velocity / 127.0f);
-    }
-    else
-    {
-        // No notes in release phase: restart the "stalest" one we could find
-        pStalestVoiceOfAll->restart(eventCounter, noteNumber, noteFrequency, velocity / 127.0f);
-    }
+    // all voices in use: steal the stalest one in its release phase, or else the stalest of all
+    v = allocator.voiceToSteal();
+    if (v < 0) return;
+    data->noteChanged(v, data->voices[v].noteNumber, noteNumber);
+    data->voices[v].restart(eventCounter, noteNumber, noteFrequency, velocity / 127.0f);
+    allocator.moveTo(v, DunneCore::VoiceAllocator::kActive);
 }
 
 void CoreSynth::stop(unsigned noteNumber, bool immediate)
 {
     DunneCore::SynthVoice *pVoice = voicePlayingNote(noteNumber);
     if (pVoice == 0) return;
+    stopVoice(voiceIndex(pVoice), immediate);
+}
 
+void CoreSynth::stopVoice(int voice, bool immediate)
+{
+    DunneCore::SynthVoice *pVoice = &data->voices[voice];
     if (immediate)
     {
+        data->noteChanged(voice, pVoice->noteNumber, -1);
         pVoice->stop(eventCounter);
+        data->voiceAllocator.moveTo(voice, DunneCore::VoiceAllocator::kFree);
     }
     else
     {
         pVoice->release(eventCounter);
+        data->voiceAllocator.moveTo(voice, DunneCore::VoiceAllocator::kReleasing);
     }
 }
 
+void CoreSynth::loadWavetable(const float *pSamples, int sampleCount, int frameLength)
+{
+    // only one loader at a time
+    if (data->wavetableLoader.joinable()) data->wavetableLoader.join();
+
+    std::vector<float> samples(pSamples, pSamples + sampleCount);
+    InternalData *pData = data.get();
+    data->wavetableLoader = std::thread([pData, samples, frameLength]()
+    {
+        std::shared_ptr<DunneCore::Wavetable> pTable(new DunneCore::Wavetable);
+        pTable->init(samples.data(), int(samples.size()), frameLength);
+
+        std::lock_guard<std::mutex> lock(pData->wavetableMutex);
+        pData->oldWavetable.reset();
+        pData->newWavetable = pTable;
+        pData->isNewWavetableReady = true;
+    });
+}
+
+void CoreSynth::setWavetableMixLevel(float value)
+{
+    data->voiceParameters.osc4.mixLevel = value;
+}
+float CoreSynth::getWavetableMixLevel(void)
+{
+    return data->voiceParameters.osc4.mixLevel;
+}
+
+bool CoreSynth::addModulationRoute(int source, int destination, float amount)
+{
+    return data->modulation.edit()->addRoute(source, destination, amount);
+}
+
+void CoreSynth::clearModulationRoutes(void)
+{
+    data->modulation.edit()->clearRoutes();
+}
+
+void CoreSynth::setDefaultModulationRoutes(void)
+{
+    data->modulation.edit()->setDefaultRoutes();
+}
+
+void CoreSynth::setVoiceLFOFrequency(float value)
+{
+    data->voiceLFOFrequency = value;
+    data->voiceParameters.voiceLFOPhaseDelta = (float)(value / data->vibratoLFO.sampleRateHz);
+}
+float CoreSynth::getVoiceLFOFrequency(void)
+{
+    return data->voiceLFOFrequency;
+}
+
+void CoreSynth::setFilterType(int value)
+{
+    data->voiceParameters.filterType = value;
+}
+int CoreSynth::getFilterType(void)
+{
+    return data->voiceParameters.filterType;
+}
+
 void CoreSynth::render(unsigned channelCount, unsigned sampleCount, float *outBuffers[])
 {
     float *pOutLeft = outBuffers[0];
     float *pOutRight = outBuffers[1];
+
+    // pick up a newly-loaded wavetable, but never wait for the loader to get one
+    if (data->isNewWavetableReady && data->wavetableMutex.try_lock())
+    {
+        data->oldWavetable = std::move(data->wavetable);
+        data->wavetable = std::move(data->newWavetable);
+        data->isNewWavetableReady = false;
+        data->wavetableMutex.unlock();
+        for (auto& voice : data->voices) voice.osc4.setWavetable(data->wavetable.get());
+    }
+    data->applyParameterChanges();
+    data->voiceParameters.osc4.position = wavetablePosition;
     
-    float pitchDev = pitchOffset + vibratoDepth * data->vibratoLFO.getSample();
-    float phaseDeltaMultiplier = pow(2.0f, pitchDev / 12.0);
+    float vibrato = data->vibratoLFO.getSample();
+    float pitchDev = pitchOffset + vibratoDepth * vibrato;
+    float phaseDeltaMultiplier = DunneCore::fastSemitonesToRatio(pitchDev);
 
-    for (int i=0; i < MAX_VOICE_COUNT; i++)
+    // per-chunk updates for each voice
+    const int bankSize = DunneCore::SynthVoiceBank::maxVoices;
+    const int voiceCount = int(data->voices.size());
+    for (auto& bank : data->voiceBanks) bank.setFilterType(data->voiceParameters.filterType);
+    std::fill(data->bankVoiceCount.begin(), data->bankVoiceCount.end(), 0);
+    data->activeVoiceCount = 0;
+    for (int i=0; i < voiceCount; i++)
     {
-        auto pVoice = data->voice[i].get();
+        auto pVoice = &data->voices[i];
+        DunneCore::SynthVoiceBank& bank = data->voiceBanks[i / bankSize];
+        int column = i % bankSize;
         int nn = pVoice->noteNumber;
+        bank.isActive[column] = false;
         if (nn >= 0)
         {
-            if (pVoice->prepToGetSamples(masterVolume, phaseDeltaMultiplier, cutoffMultiple, cutoffEnvelopeStrength, linearResonance) ||
-                pVoice->getSamples(sampleCount, pOutLeft, pOutRight))
+            if (pVoice->prepToGetSamples(masterVolume, phaseDeltaMultiplier, cutoffMultiple, cutoffEnvelopeStrength, vibrato))
+            {
+                // this voice, not necessarily the one voicePlayingNote(nn) would find
+                eventCounter++;
+                stopVoice(i, true);
+            }
+            else
+            {
+
+                bank.isActive[column] = true;
+                data->activeVoices[data->activeVoiceCount++] = i;
+                bank.gain[column] = pVoice->tempGain;
+                bank.setFilterParameters(column, pVoice->filterCutoffHz, linearResonance);
+                data->bankVoiceCount[i / bankSize] = column + 1;
+            }
+        }
+    }
+
+    // Oscillators run voice by voice, on renderPool's threads if it has several; gain, filters and
+    // mixing then run across voices on this thread, bank by bank in voice order, so the output is
+    // the same however many threads there are.
+    const int activeVoiceCount = data->activeVoiceCount;
+    const bool isParallel = data->renderPool.getThreadCount() > 1 && activeVoiceCount > 1;
+    for (unsigned offset=0; offset < sampleCount; offset += DunneCore::SynthVoiceBank::maxChunkSize)
+    {
+        int count = int(sampleCount - offset);
+        if (count > DunneCore::SynthVoiceBank::maxChunkSize) count = DunneCore::SynthVoiceBank::maxChunkSize;
+
+        if (isParallel)
+        {
+            data->chunkSampleCount = count;
+            data->renderPool.run(InternalData::renderOscillators, data.get());
+            for (int n=0; n < activeVoiceCount; n++)
             {
-                stopNote(nn, true);
+                int i = data->activeVoices[n];
+                DunneCore::SynthVoiceBank& bank = data->voiceBanks[i / bankSize];
+                for (int ch=0; ch < 2; ch++)
+                    for (int s=0; s < count; s++) bank.input[ch][s][i % bankSize] = data->voiceOutput[i].samples[ch][s];
             }
         }
+        else
+        {
+            for (int n=0; n < activeVoiceCount; n++)
+            {
+                int i = data->activeVoices[n];
+                DunneCore::SynthVoiceBank& bank = data->voiceBanks[i / bankSize];
+                int column = i % bankSize;
+                data->voices[i].getOscillatorSamples(count, &bank.input[0][0][column], &bank.input[1][0][column], bankSize);
+            }
+        }
+        for (int b=0; b < int(data->voiceBanks.size()); b++)
+        {
+            if (data->bankVoiceCount[b] == 0) continue;
+            data->voiceBanks[b].process(count, data->bankVoiceCount[b], data->voiceParameters.filterStages,
+                                        pOutLeft + offset, pOutRight + offset);
+        }
     }
 }
 
 void CoreSynth::setAmpAttackDurationSeconds(float value)
 {
-    data->ampEGParameters.setAttackDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateAmpAdsrParameters();
+    auto pParameters = data->ampEGParameters.edit();
+    pParameters->setAttackDurationSeconds(value);
+    pParameters->updateSegments();
 }
 float CoreSynth::getAmpAttackDurationSeconds(void)
 {
-    return data->ampEGParameters.getAttackDurationSeconds();
+    return data->ampEGParameters.read()->getAttackDurationSeconds();
 }
 void  CoreSynth::setAmpDecayDurationSeconds(float value)
 {
-    data->ampEGParameters.setDecayDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateAmpAdsrParameters();
+    auto pParameters = data->ampEGParameters.edit();
+    pParameters->setDecayDurationSeconds(value);
+    pParameters->updateSegments();
 }
 float CoreSynth::getAmpDecayDurationSeconds(void)
 {
-    return data->ampEGParameters.getDecayDurationSeconds();
+    return data->ampEGParameters.read()->getDecayDurationSeconds();
 }
 void  CoreSynth::setAmpSustainFraction(float value)
 {
-    data->ampEGParameters.sustainFraction = value;
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateAmpAdsrParameters();
+    auto pParameters = data->ampEGParameters.edit();
+    pParameters->sustainFraction = value;
+    pParameters->updateSegments();
 }
 float CoreSynth::getAmpSustainFraction(void)
 {
-    return data->ampEGParameters.sustainFraction;
+    return data->ampEGParameters.read()->sustainFraction;
 }
 void  CoreSynth::setAmpReleaseDurationSeconds(float value)
 {
-    data->ampEGParameters.setReleaseDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateAmpAdsrParameters();
+    auto pParameters = data->ampEGParameters.edit();
+    pParameters->setReleaseDurationSeconds(value);
+    pParameters->updateSegments();
 }
 
 float CoreSynth::getAmpReleaseDurationSeconds(void)
 {
-    return data->ampEGParameters.getReleaseDurationSeconds();
+    return data->ampEGParameters.read()->getReleaseDurationSeconds();
 }
 
 void  CoreSynth::setFilterAttackDurationSeconds(float value)
 {
-    data->filterEGParameters.setAttackDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateFilterAdsrParameters();
+    auto pParameters = data->filterEGParameters.edit();
+    pParameters->setAttackDurationSeconds(value);
+    pParameters->updateSegments();
 }
 float CoreSynth::getFilterAttackDurationSeconds(void)
 {
-    return data->filterEGParameters.getAttackDurationSeconds();
+    return data->filterEGParameters.read()->getAttackDurationSeconds();
 }
 void  CoreSynth::setFilterDecayDurationSeconds(float value)
 {
-    data->filterEGParameters.setDecayDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateFilterAdsrParameters();
+    auto pParameters = data->filterEGParameters.edit();
+    pParameters->setDecayDurationSeconds(value);
+    pParameters->updateSegments();
 }
 float CoreSynth::getFilterDecayDurationSeconds(void)
 {
-    return data->filterEGParameters.getDecayDurationSeconds();
+    return data->filterEGParameters.read()->getDecayDurationSeconds();
 }
 void  CoreSynth::setFilterSustainFraction(float value)
 {
-    data->filterEGParameters.sustainFraction = value;
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateFilterAdsrParameters();
+    auto pParameters = data->filterEGParameters.edit();
+    pParameters->sustainFraction = value;
+    pParameters->updateSegments();
 }
 float CoreSynth::getFilterSustainFraction(void)
 {
-    return data->filterEGParameters.sustainFraction;
+    return data->filterEGParameters.read()->sustainFraction;
 }
 void  CoreSynth::setFilterReleaseDurationSeconds(float value)
 {
-    data->filterEGParameters.setReleaseDurationSeconds(value);
-    for (int i = 0; i < MAX_VOICE_COUNT; i++) data->voice[i]->updateFilterAdsrParameters();
+    auto pParameters = data->filterEGParameters.edit();
+    pParameters->setReleaseDurationSeconds(value);
+    pParameters->updateSegments();
 }
 float CoreSynth::getFilterReleaseDurationSeconds(void)
 {
-    return data->filterEGParameters.getReleaseDurationSeconds();
+    return data->filterEGParameters.read()->getReleaseDurationSeconds();
 }
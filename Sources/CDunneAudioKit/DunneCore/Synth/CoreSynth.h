@@ -18,6 +18,24 @@ public:
     
     /// returns system error code, nonzero only if a problem occurs
     int init(double sampleRate);
+
+    /// Seed of the oscillators' random starting phases, used from the next init(). Each voice draws
+    /// its own stream, so renders with the same seed are identical, whatever the thread.
+    void setRandomSeed(unsigned seed);
+
+    /// Number of voices, allocated in one block by the next init() (default 32, at most 1024). A
+    /// note played again while its voice is releasing takes another voice if one is free, so more
+    /// than 128 voices can sound at once.
+    void setVoiceCount(int voiceCount);
+    int  getVoiceCount(void);
+
+    /// Run the sounding voices' oscillators on threadCount threads in all (default 1: the audio
+    /// thread alone; at most one per hardware thread), each taking a share of the voices. The
+    /// output is the same for any count.
+    /// Worker threads are started by the next init(), and stopped by deinit(), never while rendering.
+    void setRenderThreadCount(int threadCount);
+    /// the number of threads render() is using now
+    int  getRenderThreadCount(void);
     
     /// call this to un-load all samples and clear the keymap
     void deinit();
@@ -43,6 +61,28 @@ public:
     float getFilterSustainFraction(void);
     void  setFilterReleaseDurationSeconds(float value);
     float getFilterReleaseDurationSeconds(void);
+
+    /// copy the given single-cycle frames (frameLength samples each) and build a new wavetable
+    /// from them on a background thread; render() switches to it as soon as it is ready
+    void loadWavetable(const float *pSamples, int sampleCount, int frameLength);
+
+    void  setWavetableMixLevel(float value);
+    float getWavetableMixLevel(void);
+
+    /// Modulation routes, each taking a DunneCore::ModulationSource to a ModulationDestination by
+    /// amount; see DunneCore::ModulationMatrix. The default routes velocity and amp EG to amp, and
+    /// filter EG to cutoff. addModulationRoute() returns false if the route can't be added.
+    bool addModulationRoute(int source, int destination, float amount);
+    void clearModulationRoutes(void);
+    void setDefaultModulationRoutes(void);
+
+    /// frequency of each voice's own LFO, restarted with every note (default 1 Hz)
+    void  setVoiceLFOFrequency(float value);
+    float getVoiceLFOFrequency(void);
+
+    /// 0 = resonant low-pass (default), 1 = state-variable, 2 = ladder; see DunneCore::VoiceFilter
+    void  setFilterType(int value);
+    int   getFilterType(void);
     
     void render(unsigned channelCount, unsigned sampleCount, float *outBuffers[]);
     
@@ -56,6 +96,9 @@ protected:
     
     // performance parameters
     float masterVolume, pitchOffset, vibratoDepth;
+
+    /// wavetable morph position, 0.0 = first frame, 1.0 = last frame
+    float wavetablePosition;
     
     // filter parameters
     
@@ -70,8 +113,11 @@ protected:
     
     void play(unsigned noteNumber, unsigned velocity, float noteFrequency);
     void stop(unsigned noteNumber, bool immediate);
+    void stopVoice(int voice, bool immediate);
     
+    /// the voice most recently given noteNumber, if it still has it, else null; constant time
     DunneCore::SynthVoice *voicePlayingNote(unsigned noteNumber);
+    int voiceIndex(DunneCore::SynthVoice *pVoice);
 };
 
 #endif
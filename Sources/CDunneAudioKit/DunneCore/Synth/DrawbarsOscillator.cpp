@@ -10,14 +10,16 @@ namespace DunneCore
     // 9 Hammond drawbars mapped to harmonic numbers, minus 1 for a 0-based array
     const int DrawbarsOscillator::drawBarMap[9] = { 0, 2, 1, 3, 5, 7, 9, 11, 15 };
 
-    void DrawbarsOscillator::init(double sampleRate, WaveStack *pStack)
+    void DrawbarsOscillator::init(double sampleRate, const WaveStack *pStack)
     {
         sampleRateHz = sampleRate;
         pWaveStack = pStack;
         phaseDeltaMultiplier = 1.0f;
         for (int i=0; i < phaseCount; i++)
         {
-            phase[i] = phaseDelta[i] = 0.0f;
+            phase[i] = phaseIncrement[i] = 0;
+            phaseDelta[i] = 0.0f;
+            octaveFade[i] = 0.0f;
             safetyLevels[i] = 0.0f;
         }
         level = safetyLevels;
@@ -31,16 +33,11 @@ namespace DunneCore
         // set each phase's normalized frequency
         for (int i=0; i < phaseCount; i++)
         {
-            octave[i] = 0;
             phaseDelta[i] = (i + 1) * (float)normalizedFrequency;
-            int length = 1 << WaveStack::maxBits;
-            while (phaseDelta[i] * length >= 1.0f)
-            {
-                octave[i]++;
-                length >>= 1;
-            }
+            phaseIncrement[i] = WaveStack::phaseIncrement(double(phaseDeltaMultiplier) * phaseDelta[i]);
+            octave[i] = WaveStack::octaveFor(phaseDelta[i], &octaveFade[i]);
 
-            // frequency components beyond octave 9 must be suppressed
+            // frequency components beyond the top octave level must be suppressed
             if (octave[i] >= WaveStack::maxBits)
             {
                 octave[i] = 0;
@@ -49,15 +46,26 @@ namespace DunneCore
         }
     }
 
+    void DrawbarsOscillator::setPhaseDeltaMultiplier(float multiplier)
+    {
+        if (multiplier == phaseDeltaMultiplier) return;
+        phaseDeltaMultiplier = multiplier;
+        for (int i=0; i < phaseCount; i++)
+            phaseIncrement[i] = WaveStack::phaseIncrement(double(multiplier) * phaseDelta[i]);
+    }
+
     float DrawbarsOscillator::getSample()
     {
         float sample = 0.0f;
         for (int i=0; i < phaseCount; i++)
         {
             if (level[i] == 0.0f) continue;
+#if WAVESTACK_OCTAVE_CROSSFADE
+            sample += level[i] * pWaveStack->interp(octave[i], phase[i], octaveFade[i]);
+#else
             sample += level[i] * pWaveStack->interp(octave[i], phase[i]);
-            phase[i] += phaseDeltaMultiplier * phaseDelta[i];
-            if (phase[i] >= 1.0f) phase[i] -= 1.0f;
+#endif
+            phase[i] += phaseIncrement[i];
         }
         return sample;
     }
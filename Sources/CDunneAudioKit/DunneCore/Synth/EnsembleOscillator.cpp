@@ -6,7 +6,7 @@
 
 namespace DunneCore
 {
-    void EnsembleOscillator::init(double sampleRate, WaveStack *pStack)
+    void EnsembleOscillator::init(double sampleRate, const WaveStack *pStack)
     {
         sampleRateHz = sampleRate;
         pWaveStack = pStack;
@@ -15,8 +15,11 @@ namespace DunneCore
         phaseDeltaMultiplier = 1.0f;
         for (int i=0; i < maxPhases; i++)
         {
-            phase[i] = dis(*gen);
+            phase[i] = random.nextUInt32();
             phaseDelta[i] = 0.0f;
+            phaseIncrement[i] = 0;
+            octave[i] = 0;
+            octaveFade[i] = 0.0f;
             rightGain[i] = leftGain[i] = 0.5f;
         }
     }
@@ -65,14 +68,10 @@ namespace DunneCore
         if (phaseCount == 1)
         {
             // single phase case: just set normalized center frequency
-            octave[0] = 0;
             phaseDelta[0] = (float)normalizedFrequency;
-            int length = 1 << WaveStack::maxBits;
-            while (phaseDelta[0] * length >= 1.0f)
-            {
-                octave[0]++;
-                length >>= 1;
-            }
+            octave[0] = WaveStack::octaveFor(phaseDelta[0], &octaveFade[0]);
+            if (octave[0] >= WaveStack::maxBits) octave[0] = WaveStack::maxBits - 1;
+            phaseIncrement[0] = WaveStack::phaseIncrement(double(phaseDeltaMultiplier) * phaseDelta[0]);
             return;
         }
 
@@ -87,18 +86,22 @@ namespace DunneCore
         // set each phase's normalized frequency, stepping up by full steps
         for (int i=0; i < phaseCount; i++)
         {
-            octave[i] = 0;
             phaseDelta[i] = (float)normalizedFrequency;
+            phaseIncrement[i] = WaveStack::phaseIncrement(double(phaseDeltaMultiplier) * phaseDelta[i]);
             normalizedFrequency *= deltaMultiplier;
-            int length = 1 << WaveStack::maxBits;
-            while (phaseDelta[i] * length >= 1.0f)
-            {
-                octave[i]++;
-                length >>= 1;
-            }
+            octave[i] = WaveStack::octaveFor(phaseDelta[i], &octaveFade[i]);
+            if (octave[i] >= WaveStack::maxBits) octave[i] = WaveStack::maxBits - 1;
         }
     }
 
+    void EnsembleOscillator::setPhaseDeltaMultiplier(float multiplier)
+    {
+        if (multiplier == phaseDeltaMultiplier) return;
+        phaseDeltaMultiplier = multiplier;
+        for (int i=0; i < phaseCount; i++)
+            phaseIncrement[i] = WaveStack::phaseIncrement(double(multiplier) * phaseDelta[i]);
+    }
+
     // Mono output: no panning
     float EnsembleOscillator::getSample()
     {
@@ -109,9 +112,12 @@ namespace DunneCore
 
         for (int i=0; i < phaseCount; i++)
         {
+#if WAVESTACK_OCTAVE_CROSSFADE
+            sample += gain * pWaveStack->interp(octave[i], phase[i], octaveFade[i]);
+#else
             sample += gain * pWaveStack->interp(octave[i], phase[i]);
-            phase[i] += phaseDeltaMultiplier * phaseDelta[i];
-            if (phase[i] >= 1.0f) phase[i] -= 1.0f;
+#endif
+            phase[i] += phaseIncrement[i];
         }
         return sample;
     }
@@ -124,9 +130,12 @@ namespace DunneCore
 
         for (int i=0; i < phaseCount; i++)
         {
+#if WAVESTACK_OCTAVE_CROSSFADE
+            float sample = pWaveStack->interp(octave[i], phase[i], octaveFade[i]);
+#else
             float sample = pWaveStack->interp(octave[i], phase[i]);
-            phase[i] += phaseDeltaMultiplier * phaseDelta[i];
-            if (phase[i] >= 1.0f) phase[i] -= 1.0f;
+#endif
+            phase[i] += phaseIncrement[i];
 
             leftSample += gain * leftGain[i] * sample;
             rightSample += gain * rightGain[i] * sample;
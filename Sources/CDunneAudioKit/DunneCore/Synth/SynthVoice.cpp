@@ -1,15 +1,24 @@
 // Copyright AudioKit. All Rights Reserved.
 
 #include "SynthVoice.h"
+#include "FastMath.h"
+#include "LookupTables.h"
 #include <stdio.h>
 
 namespace DunneCore
 {
 
+    void SynthVoice::setRandomStream(uint32_t seed, int voiceIndex)
+    {
+        osc1.random.setStream(seed, uint32_t(2 * voiceIndex));
+        osc2.random.setStream(seed, uint32_t(2 * voiceIndex + 1));
+    }
+
     void SynthVoice::init(double sampleRate,
-                          WaveStack *pOsc1Stack,
-                          WaveStack *pOsc2Stack,
-                          WaveStack *pOsc3Stack,
+                          const WaveStack *pOsc1Stack,
+                          const WaveStack *pOsc2Stack,
+                          const WaveStack *pOsc3Stack,
+                          const Wavetable *pOsc4Table,
                           SynthVoiceParameters *pParams,
                           EnvelopeParameters *pEnvParameters)
     {
@@ -30,26 +39,29 @@ namespace DunneCore
         osc3.init(sampleRate, pOsc3Stack);
         osc3.level = pParameters->osc3.drawbars;
 
-        leftFilter.init(sampleRate);
-        rightFilter.init(sampleRate);
-        leftFilter.setStages(pParameters->filterStages);
-        rightFilter.setStages(pParameters->filterStages);
+        osc4.init(sampleRate, pOsc4Table);
 
         ampEG.init();
         filterEG.init();
         pumpEG.init(pEnvParameters);
+
+        // its phaseDelta comes from pParameters->voiceLFOPhaseDelta, at every chunk it is used
+        voiceLFO.init(sineTable.values, sineTableSize, sampleRate, 0.0f);
     }
 
     void SynthVoice::start(unsigned evt, unsigned noteNum, float frequency, float volume)
     {
         event = evt;
         noteVolume = volume;
-        osc1.setFrequency(frequency * pow(2.0f, pParameters->osc1.pitchOffset / 12.0f));
-        osc2.setFrequency(frequency * pow(2.0f, pParameters->osc2.pitchOffset / 12.0f));
+        osc1.setFrequency(frequency * fastSemitonesToRatio(pParameters->osc1.pitchOffset));
+        osc2.setFrequency(frequency * fastSemitonesToRatio(pParameters->osc2.pitchOffset));
         osc3.setFrequency(frequency);
+        osc4.setFrequency(frequency);
+        osc4.setPosition(pParameters->osc4.position);
         ampEG.start();
         filterEG.start();
         pumpEG.start();
+        voiceLFO.phase = 0.0f;
         
         noteFrequency = frequency;
         noteNumber = noteNum;
@@ -58,7 +70,8 @@ namespace DunneCore
     void SynthVoice::restart(unsigned evt, float volume)
     {
         event = evt;
-        newNoteNumber = -1;
+        // if still silencing a stolen note, the new note's frequency is yet to be set
+        if (!ampEG.isPreStarting()) newNoteNumber = -1;
         newNoteVol = volume;
         ampEG.restart();
         pumpEG.restart();
@@ -67,6 +80,8 @@ namespace DunneCore
     void SynthVoice::restart(unsigned evt, unsigned noteNum, float frequency, float volume)
     {
         event = evt;
+        // the voice belongs to the new note from now on, though the old one sounds a little longer
+        noteNumber = noteNum;
         newNoteNumber = noteNum;
         newNoteVol = volume;
         noteFrequency = frequency;
@@ -95,75 +110,126 @@ namespace DunneCore
                                       float phaseDeltaMultiplier,
                                       float cutoffMultiple,
                                       float cutoffStrength,
-                                      float resLinear)
+                                      float vibrato)
     {
         if (ampEG.isIdle()) return true;
 
-        if (ampEG.isPreStarting())
+        bool wasPreStarting = ampEG.isPreStarting();
+        float ampeg = ampEG.getSample();
+        if (wasPreStarting)
         {
-            float ampeg = ampEG.getSample();
-            tempGain = masterVolume * noteVolume * ampeg;
             if (!ampEG.isPreStarting())
             {
                 noteVolume = newNoteVol;
-                tempGain = masterVolume * noteVolume * ampeg;
 
                 if (newNoteNumber >= 0)
                 {
                     // restarting a "stolen" voice with a new note number
-                    osc1.setFrequency(noteFrequency * pow(2.0f, pParameters->osc1.pitchOffset / 12.0f));
-                    osc2.setFrequency(noteFrequency * pow(2.0f, pParameters->osc2.pitchOffset / 12.0f));
+                    osc1.setFrequency(noteFrequency * fastSemitonesToRatio(pParameters->osc1.pitchOffset));
+                    osc2.setFrequency(noteFrequency * fastSemitonesToRatio(pParameters->osc2.pitchOffset));
                     osc3.setFrequency(noteFrequency);
-                    noteNumber = newNoteNumber;
+                    osc4.setFrequency(noteFrequency);
+                    osc4.setPosition(pParameters->osc4.position);
                 }
                 ampEG.start();
                 filterEG.start();
                 pumpEG.start();
+                voiceLFO.phase = 0.0f;
             }
         }
-        else
-            tempGain = masterVolume * noteVolume * ampEG.getSample();
-
-#if 0
-        // pumping effect using multi-segment EG
-        float pump = pumpEG.getSample();
-        double cutoffFrequency = noteFrequency * (1.0f + cutoffMultiple + cutoffStrength * pump);
-#else
-        // standard ADSR EG
-        double cutoffFrequency = noteFrequency * (1.0f + cutoffMultiple + cutoffStrength * filterEG.getSample());
-#endif
-        leftFilter.setParameters(cutoffFrequency, resLinear);
-        rightFilter.setParameters(cutoffFrequency, resLinear);
-
-        osc1.phaseDeltaMultiplier = phaseDeltaMultiplier;
-        osc2.phaseDeltaMultiplier = phaseDeltaMultiplier;
-        osc3.phaseDeltaMultiplier = phaseDeltaMultiplier;
+
+        // sources: envelopes and the voice LFO advance whether or not any route reads them, so a
+        // route added mid-note picks them up where they should be; only the routing is skipped
+        const ModulationMatrix& modulation = *pModulation;
+        float source[kModulationSourceCount];
+        source[kAmpEGSource] = ampeg;
+        source[kVelocitySource] = noteVolume;
+        source[kVibratoLFOSource] = vibrato;
+        source[kFilterEGSource] = filterEG.getSample();
+        source[kPumpEGSource] = pumpEG.getSample();
+        voiceLFO.phaseDelta = pParameters->voiceLFOPhaseDelta;
+        if (modulation.isUsed(kVoiceLFOSource)) source[kVoiceLFOSource] = voiceLFO.getSample();
+        else voiceLFO.advance();
+
+        tempGain = masterVolume;
+        for (auto op = modulation.begin(kAmpDestination); op != modulation.end(kAmpDestination); op++)
+            tempGain *= (1.0f - op->amount) + op->amount * source[op->source];
+
+        float cutoffModulation = 0.0f;
+        for (auto op = modulation.begin(kCutoffDestination); op != modulation.end(kCutoffDestination); op++)
+            cutoffModulation += op->amount * source[op->source];
+        filterCutoffHz = noteFrequency * (1.0f + cutoffMultiple + cutoffStrength * cutoffModulation);
+
+        if (modulation.begin(kPitchDestination) != modulation.end(kPitchDestination))
+        {
+            float semitones = 0.0f;
+            for (auto op = modulation.begin(kPitchDestination); op != modulation.end(kPitchDestination); op++)
+                semitones += op->amount * source[op->source];
+            phaseDeltaMultiplier *= fastSemitonesToRatio(semitones);
+        }
+
+        osc1.setPhaseDeltaMultiplier(phaseDeltaMultiplier);
+        osc2.setPhaseDeltaMultiplier(phaseDeltaMultiplier);
+        osc3.setPhaseDeltaMultiplier(phaseDeltaMultiplier);
+        osc4.phaseDeltaMultiplier = phaseDeltaMultiplier;
 
         return false;
     }
     
-    bool SynthVoice::getSamples(int sampleCount, float *leftOutput, float *rightOutput)
+    void SynthVoice::getOscillatorSamples(int sampleCount, float *pLeft, float *pRight, int stride)
     {
-        for (int i=0; i < sampleCount; i++)
+        bool osc4Active = pParameters->osc4.mixLevel != 0.0f && osc4.pWavetable && osc4.pWavetable->frameCount() > 0;
+        if (osc4Active)
+            mixOscillators<true>(sampleCount, pLeft, pRight, stride);
+        else
         {
-            float leftSample = 0.0f;
-            float rightSample = 0.0f;
-            osc1.getSamples(&leftSample, &rightSample, pParameters->osc1.mixLevel);
-            osc2.getSamples(&leftSample, &rightSample, pParameters->osc2.mixLevel);
-            osc3.getSamples(&leftSample, &rightSample, pParameters->osc3.mixLevel);
+            mixOscillators<false>(sampleCount, pLeft, pRight, stride);
+            osc4.setPosition(pParameters->osc4.position);
+        }
+    }
 
-            if (pParameters->filterStages == 0)
+    template<bool isOsc4Active>
+    void SynthVoice::mixOscillators(int sampleCount, float *pLeft, float *pRight, int stride)
+    {
+        // mix levels are read once, not for every sample through pParameters
+        const float osc1Level = pParameters->osc1.mixLevel;
+        const float osc2Level = pParameters->osc2.mixLevel;
+        const float osc3Level = pParameters->osc3.mixLevel;
+        const float osc4Level = pParameters->osc4.mixLevel;
+
+        // The wavetable oscillator renders whole blocks, so that it can morph smoothly across
+        // each one; other oscillators are still rendered sample by sample.
+        const int osc4BlockSize = 16;
+        float osc4Samples[osc4BlockSize];
+        float osc4StartPosition = osc4.position;
+        float osc4PositionChange = pParameters->osc4.position - osc4StartPosition;
+
+        for (int blockStart=0; blockStart < sampleCount; blockStart += osc4BlockSize)
+        {
+            int blockSize = sampleCount - blockStart;
+            if (blockSize > osc4BlockSize) blockSize = osc4BlockSize;
+            if (isOsc4Active)
             {
-                *leftOutput++ += tempGain * leftSample;
-                *rightOutput++ += tempGain * rightSample;
+                float blockEndPosition = osc4StartPosition + osc4PositionChange * (blockStart + blockSize) / sampleCount;
+                osc4.getSamples(blockSize, osc4Samples, blockEndPosition);
             }
-            else
+
+            for (int i=0; i < blockSize; i++)
             {
-                *leftOutput++ += leftFilter.process(tempGain * leftSample);
-                *rightOutput++ += rightFilter.process(tempGain * rightSample);
+                float leftSample = 0.0f;
+                float rightSample = 0.0f;
+                osc1.getSamples(&leftSample, &rightSample, osc1Level);
+                osc2.getSamples(&leftSample, &rightSample, osc2Level);
+                osc3.getSamples(&leftSample, &rightSample, osc3Level);
+                if (isOsc4Active)
+                {
+                    leftSample += osc4Level * osc4Samples[i];
+                    rightSample += osc4Level * osc4Samples[i];
+                }
+                pLeft[(blockStart + i) * stride] = leftSample;
+                pRight[(blockStart + i) * stride] = rightSample;
             }
         }
-        return false;
     }
 
 }
@@ -0,0 +1,316 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "SynthVoiceBank.h"
+#include "ResonantLowPassFilter.h"
+
+namespace DunneCore
+{
+
+    void SynthVoiceBank::init(double sampleRate)
+    {
+        sampleRateHz = sampleRate;
+        filterType = VoiceFilter::kResonantLowPass;
+        for (int v=0; v < maxVoices; v++)
+        {
+            isActive[v] = false;
+            gain[v] = 0.0f;
+            lastCutoffHz[v] = lastResLinear[v] = -1.0;  // force recalc of coefficients
+            g[v] = e1[v] = e2[v] = gTarget[v] = e1Target[v] = e2Target[v] = 0.0f;
+            tptG[v] = tptK[v] = tptGTarget[v] = tptKTarget[v] = 0.0f;
+        }
+        for (int ch=0; ch < 2; ch++)
+            for (int n=0; n < maxStateValues; n++)
+                for (int v=0; v < maxVoices; v++)
+                    state[ch][n][v] = 0.0f;
+    }
+
+    void SynthVoiceBank::setFilterType(int newType)
+    {
+        if (newType < 0 || newType >= VoiceFilter::kFilterTypeCount) newType = VoiceFilter::kResonantLowPass;
+        if (newType == filterType) return;
+
+        init(sampleRateHz);
+        filterType = VoiceFilter::FilterType(newType);
+    }
+
+    void SynthVoiceBank::setFilterParameters(int voiceIndex, double newCutoffHz, double newResLinear)
+    {
+        int v = voiceIndex;
+        if (newCutoffHz == lastCutoffHz[v] && newResLinear == lastResLinear[v]) return;
+
+        if (filterType == VoiceFilter::kResonantLowPass)
+        {
+            ResonantLowPassFilter::calculateCoefficients(sampleRateHz, newCutoffHz, newResLinear,
+                                                         gTarget[v], e1Target[v], e2Target[v]);
+
+            // no ramp from the values left by init()
+            if (lastCutoffHz[v] < 0.0)
+            {
+                g[v] = gTarget[v];
+                e1[v] = e1Target[v];
+                e2[v] = e2Target[v];
+            }
+        }
+        else
+        {
+            tptGTarget[v] = StateVariableFilter::gainFor(sampleRateHz, newCutoffHz);
+            tptKTarget[v] = filterType == VoiceFilter::kLadder ? LadderFilter::feedbackFor(newResLinear)
+                                                               : StateVariableFilter::dampingFor(newResLinear);
+
+            // no ramp from the values left by init()
+            if (lastCutoffHz[v] < 0.0)
+            {
+                tptG[v] = tptGTarget[v];
+                tptK[v] = tptKTarget[v];
+            }
+        }
+        lastCutoffHz[v] = newCutoffHz;
+        lastResLinear[v] = newResLinear;
+    }
+
+    int SynthVoiceBank::stateValueCount(int filterStages)
+    {
+        switch (filterType)
+        {
+            case VoiceFilter::kStateVariable: return 2 * filterStages;
+            case VoiceFilter::kLadder: return filterStages > 0 ? LadderFilter::poles : 0;
+            default: return 4 * filterStages;
+        }
+    }
+
+    void SynthVoiceBank::process(int sampleCount, int voiceCount, int filterStages, float *pOutLeft, float *pOutRight)
+    {
+        if (filterStages < 0) filterStages = 0;
+        if (filterStages > maxStages) filterStages = maxStages;
+
+        // Voices in [0, voiceCount) which are not sounding are processed too, as silence, so the
+        // loops across voices need no per-voice conditions. Their filters must hold their state,
+        // as if they had not been processed at all, so it is saved here and restored afterwards.
+        const int stateCount = stateValueCount(filterStages);
+        int idleVoice[maxVoices];
+        float idleState[maxVoices][2][maxStateValues];
+        int idleCount = 0;
+        for (int v=0; v < voiceCount; v++)
+        {
+            if (isActive[v]) continue;
+            for (int ch=0; ch < 2; ch++)
+            {
+                for (int i=0; i < sampleCount; i++) input[ch][i][v] = 0.0f;
+                for (int n=0; n < stateCount; n++) idleState[idleCount][ch][n] = state[ch][n][v];
+            }
+            idleVoice[idleCount++] = v;
+        }
+
+        for (int ch=0; ch < 2; ch++)
+        {
+            for (int i=0; i < sampleCount; i++)
+            {
+                float *x = input[ch][i];
+                for (int v=0; v < voiceCount; v++) x[v] = gain[v] * x[v];
+            }
+        }
+
+        if (filterStages > 0)
+        {
+            switch (filterType)
+            {
+                case VoiceFilter::kStateVariable:
+                    processStateVariable(sampleCount, voiceCount, filterStages);
+                    break;
+                case VoiceFilter::kLadder:
+                    processLadder(sampleCount, voiceCount);
+                    break;
+                default:
+                    processResonantLowPass(sampleCount, voiceCount, filterStages);
+                    break;
+            }
+        }
+
+        // Idle voices' filters may still ring from before; silence them here, once, so the mix
+        // below is a plain sum with no per-voice test. Adding their zeros changes nothing.
+        for (int n=0; n < idleCount; n++)
+        {
+            int v = idleVoice[n];
+            for (int ch=0; ch < 2; ch++)
+            {
+                for (int i=0; i < sampleCount; i++) input[ch][i][v] = 0.0f;
+                for (int k=0; k < stateCount; k++) state[ch][k][v] = idleState[n][ch][k];
+            }
+        }
+
+        // summed in voice order, so results don't depend on the vector width
+        float *pOut[2] = { pOutLeft, pOutRight };
+        for (int ch=0; ch < 2; ch++)
+        {
+            for (int i=0; i < sampleCount; i++)
+            {
+                const float *x = input[ch][i];
+                float sum = pOut[ch][i];
+                for (int v=0; v < voiceCount; v++) sum += x[v];
+                pOut[ch][i] = sum;
+            }
+        }
+    }
+
+    void SynthVoiceBank::processResonantLowPass(int sampleCount, int voiceCount, int filterStages)
+    {
+        switch (filterStages)
+        {
+            case 1: processResonantLowPassStages<1>(sampleCount, voiceCount); break;
+            case 2: processResonantLowPassStages<2>(sampleCount, voiceCount); break;
+            case 3: processResonantLowPassStages<3>(sampleCount, voiceCount); break;
+            default: processResonantLowPassStages<4>(sampleCount, voiceCount); break;
+        }
+    }
+
+    template<int filterStages>
+    void SynthVoiceBank::processResonantLowPassStages(int sampleCount, int voiceCount)
+    {
+        // ramp as MultiStageFilter does, to give the same results
+        float dg[maxVoices], de1[maxVoices], de2[maxVoices];
+        for (int v=0; v < voiceCount; v++)
+        {
+            dg[v] = (gTarget[v] - g[v]) / sampleCount;
+            de1[v] = (e1Target[v] - e1[v]) / sampleCount;
+            de2[v] = (e2Target[v] - e2[v]) / sampleCount;
+        }
+
+        float cg[maxVoices], ce1[maxVoices], ce2[maxVoices];
+        for (int v=0; v < voiceCount; v++)
+        {
+            cg[v] = g[v];
+            ce1[v] = e1[v];
+            ce2[v] = e2[v];
+        }
+
+        for (int i=0; i < sampleCount; i++)
+        {
+            for (int v=0; v < voiceCount; v++)
+            {
+                cg[v] += dg[v];
+                ce1[v] += de1[v];
+                ce2[v] += de2[v];
+            }
+
+            // all the stages of a voice in one pass, the stage loop unrolled, so each sample stays
+            // in a register from the first stage to the last
+            for (int ch=0; ch < 2; ch++)
+            {
+                float *x = input[ch][i];
+                float (*st)[maxVoices] = state[ch];
+                for (int v=0; v < voiceCount; v++)
+                {
+                    float in = x[v];
+                    for (int s=0; s < filterStages; s++)
+                    {
+                        float *px1 = st[4 * s], *px2 = st[4 * s + 1], *py1 = st[4 * s + 2], *py2 = st[4 * s + 3];
+                        float y = py1[v] + ((py1[v] - py2[v]) +
+                                            (cg[v] * (in + 2.0f * px1[v] + px2[v]) - ce1[v] * py1[v] + ce2[v] * py2[v]));
+                        px2[v] = px1[v];
+                        px1[v] = in;
+                        py2[v] = py1[v];
+                        py1[v] = y;
+                        in = y;
+                    }
+                    x[v] = in;
+                }
+            }
+        }
+
+        for (int v=0; v < voiceCount; v++)
+        {
+            g[v] = gTarget[v];
+            e1[v] = e1Target[v];
+            e2[v] = e2Target[v];
+        }
+    }
+
+    void SynthVoiceBank::tptRampIncrements(int sampleCount, int voiceCount, float *dg, float *dk)
+    {
+        for (int v=0; v < voiceCount; v++)
+        {
+            dg[v] = (tptGTarget[v] - tptG[v]) / sampleCount;
+            dk[v] = (tptKTarget[v] - tptK[v]) / sampleCount;
+        }
+    }
+
+    void SynthVoiceBank::finishTptRamp(int voiceCount)
+    {
+        // land exactly on the targets, free of rounding in the increments
+        for (int v=0; v < voiceCount; v++)
+        {
+            tptG[v] = tptGTarget[v];
+            tptK[v] = tptKTarget[v];
+        }
+    }
+
+    void SynthVoiceBank::processStateVariable(int sampleCount, int voiceCount, int filterStages)
+    {
+        switch (filterStages)
+        {
+            case 1: processStateVariableStages<1>(sampleCount, voiceCount); break;
+            case 2: processStateVariableStages<2>(sampleCount, voiceCount); break;
+            case 3: processStateVariableStages<3>(sampleCount, voiceCount); break;
+            default: processStateVariableStages<4>(sampleCount, voiceCount); break;
+        }
+    }
+
+    template<int filterStages>
+    void SynthVoiceBank::processStateVariableStages(int sampleCount, int voiceCount)
+    {
+        float a1[maxVoices], a2[maxVoices], a3[maxVoices];
+        float dg[maxVoices], dk[maxVoices];
+        tptRampIncrements(sampleCount, voiceCount, dg, dk);
+
+        for (int i=0; i < sampleCount; i++)
+        {
+            for (int v=0; v < voiceCount; v++)
+            {
+                tptG[v] += dg[v];
+                tptK[v] += dk[v];
+                StateVariableFilter::coefficients(tptG[v], tptK[v], a1[v], a2[v], a3[v]);
+            }
+
+            for (int ch=0; ch < 2; ch++)
+            {
+                float *x = input[ch][i];
+                float (*st)[maxVoices] = state[ch];
+                for (int v=0; v < voiceCount; v++)
+                {
+                    float in = x[v];
+                    for (int s=0; s < filterStages; s++)
+                        in = StateVariableFilter::tick(in, a1[v], a2[v], a3[v], st[2 * s][v], st[2 * s + 1][v]);
+                    x[v] = in;
+                }
+            }
+        }
+        finishTptRamp(voiceCount);
+    }
+
+    void SynthVoiceBank::processLadder(int sampleCount, int voiceCount)
+    {
+        float G[maxVoices], beta[maxVoices], fb[maxVoices];
+        float dg[maxVoices], dk[maxVoices];
+        tptRampIncrements(sampleCount, voiceCount, dg, dk);
+
+        for (int i=0; i < sampleCount; i++)
+        {
+            for (int v=0; v < voiceCount; v++)
+            {
+                tptG[v] += dg[v];
+                tptK[v] += dk[v];
+                LadderFilter::coefficients(tptG[v], tptK[v], G[v], beta[v], fb[v]);
+            }
+
+            for (int ch=0; ch < 2; ch++)
+            {
+                float *x = input[ch][i];
+                float *ps1 = state[ch][0], *ps2 = state[ch][1], *ps3 = state[ch][2], *ps4 = state[ch][3];
+                for (int v=0; v < voiceCount; v++)
+                    x[v] = LadderFilter::tick(x[v], G[v], beta[v], tptK[v], fb[v], ps1[v], ps2[v], ps3[v], ps4[v]);
+            }
+        }
+        finishTptRamp(voiceCount);
+    }
+
+}
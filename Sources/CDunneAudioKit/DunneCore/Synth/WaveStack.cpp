@@ -3,10 +3,49 @@
 #include "WaveStack.h"
 #include "kiss_fftr.h"
 
+#include <assert.h>
+#include <map>
+#include <mutex>
+#include <utility>
+
 namespace DunneCore
 {
 
-    WaveStack::WaveStack()
+    // KissFFT plans are expensive to allocate, so we make them once per FFT length and keep
+    // them for the life of the process. A plan's scratch memory is used during each transform,
+    // so whoever holds the plans must also hold planMutex while using them.
+    struct FFTPlans
+    {
+        kiss_fftr_cfg fwd, inv;
+
+        FFTPlans(int fftLength)
+        : fwd(kiss_fftr_alloc(fftLength, 0, 0, 0))
+        , inv(kiss_fftr_alloc(fftLength, 1, 0, 0))
+        {
+        }
+
+        ~FFTPlans()
+        {
+            kiss_fftr_free(inv);
+            kiss_fftr_free(fwd);
+        }
+
+        FFTPlans(const FFTPlans&) = delete;
+        FFTPlans& operator=(const FFTPlans&) = delete;
+    };
+
+    static std::mutex planMutex;
+
+    static FFTPlans& getPlans(int fftLength)
+    {
+        static std::map<int, std::unique_ptr<FFTPlans>> plans;
+        auto& pPlans = plans[fftLength];
+        if (!pPlans) pPlans.reset(new FFTPlans(fftLength));
+        return *pPlans;
+    }
+
+    template<int MaxBits>
+    WaveStackT<MaxBits>::WaveStackT()
     {
         int length = 1 << maxBits;                  // length of level-0 data
         pData[0] = new float[2 * length];           // 2x is enough for all levels
@@ -17,31 +56,34 @@ namespace DunneCore
         }
     }
 
-    WaveStack::~WaveStack()
+    template<int MaxBits>
+    WaveStackT<MaxBits>::~WaveStackT()
     {
         delete[] pData[0];
     }
 
-    void WaveStack::initStack(const std::vector<float>& waveData, int maxHarmonic)
+    template<int MaxBits>
+    void WaveStackT<MaxBits>::initStack(const std::vector<float>& waveData, int maxHarmonic)
     {
         // setup
         const int fftLength = 1 << maxBits;
         std::vector<float> buf(fftLength);
-        kiss_fftr_cfg fwd = kiss_fftr_alloc(fftLength, 0, 0, 0);
-        kiss_fftr_cfg inv = kiss_fftr_alloc(fftLength, 1, 0, 0);
 
         assert(waveData.size() >= fftLength);
 
+        std::lock_guard<std::mutex> lock(planMutex);
+        FFTPlans& plans = getPlans(fftLength);
+
         // copy supplied wave data for octave 0
         for (int i=0; i < fftLength; i++) pData[0][i] = waveData[i];
 
         // perform initial forward FFT to get spectrum
         kiss_fft_cpx spectrum[fftLength / 2 + 1];
-        kiss_fftr(fwd, pData[0], spectrum);
+        kiss_fftr(plans.fwd, pData[0], spectrum);
 
         float scaleFactor = 1.0f / (fftLength / 2);
 
-        for (int octave = (maxHarmonic==512) ? 1 : 0; octave < maxBits; octave++)
+        for (int octave = (maxHarmonic >= fftLength / 2) ? 1 : 0; octave < maxBits; octave++)
         {
             // zero all harmonic coefficients above new Nyquist limit
             int maxHarm = 1 << (maxBits - octave - 1);
@@ -53,35 +95,76 @@ namespace DunneCore
             }
 
             // perform inverse FFT to get filtered waveform
-            kiss_fftri(inv, spectrum, buf.data());
+            kiss_fftri(plans.inv, spectrum, buf.data());
 
             // resample filtered waveform
             int skip = 1 << octave;
             float *pOut = pData[octave];
             for (int i=0; i < fftLength; i += skip) *pOut++ = scaleFactor * buf[i];
         }
+    }
+
+    template<int MaxBits>
+    int WaveStackT<MaxBits>::octaveFor(float phaseDelta, float *pOctaveFade)
+    {
+        int octave = 0;
+        int length = tableLength;
+        while (phaseDelta * length >= 1.0f)
+        {
+            octave++;
+            length >>= 1;
+        }
 
-        // teardown
-        kiss_fftr_free(inv);
-        kiss_fftr_free(fwd);
+        if (pOctaveFade)
+        {
+            // phaseDelta * length is in [0.5, 1) over the octave, except at the bottom level,
+            // so the fade is 0 where this level takes over and approaches 1 where it hands off
+            float fade = 2.0f * phaseDelta * length - 1.0f;
+            if (fade < 0.0f || octave + 1 >= maxBits) fade = 0.0f;
+            *pOctaveFade = fade;
+        }
+        return octave;
     }
 
-    float WaveStack::interp(int octave, float phase)
+    template<int MaxBits>
+    std::shared_ptr<const WaveStackT<MaxBits>> WaveStackT<MaxBits>::getShared(const std::vector<float>& waveData, int maxHarmonic)
     {
-        while (phase < 0) phase += 1.0;
-        while (phase >= 1.0) phase -= 1.0f;
-
-        int nTableSize = 1 << (maxBits - octave);
-        float readIndex = phase * nTableSize;
-        int ri = int(readIndex);
-        float f = readIndex - ri;
-        int rj = ri + 1; if (rj >= nTableSize) rj -= nTableSize;
-
-        float *pWaveTable = pData[octave];
-        float si = pWaveTable[ri];
-        float sj = pWaveTable[rj];
-        return (float)((1.0 - f) * si + f * sj);
+        // The registry holds only weak references, keyed by the harmonic limit plus the level-0
+        // samples themselves, so identical waveform definitions always map to the same stack.
+        typedef std::pair<int, std::vector<float>> Key;
+        static std::map<Key, std::weak_ptr<const WaveStackT>> registry;
+        static std::mutex registryMutex;
+
+        const int fftLength = 1 << maxBits;
+        assert(waveData.size() >= fftLength);
+        Key key(maxHarmonic, std::vector<float>(waveData.begin(), waveData.begin() + fftLength));
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+
+        // forget any stacks which are no longer in use by anyone
+        for (auto it = registry.begin(); it != registry.end(); )
+        {
+            if (it->second.expired()) it = registry.erase(it);
+            else ++it;
+        }
+
+        // last owner may have let go since we pruned, in which case we just build a new one
+        auto it = registry.find(key);
+        if (it != registry.end())
+        {
+            std::shared_ptr<const WaveStackT> pShared = it->second.lock();
+            if (pShared) return pShared;
+        }
+
+        std::shared_ptr<WaveStackT> pStack(new WaveStackT);
+        pStack->initStack(key.second, maxHarmonic);
+        registry[key] = pStack;
+        return pStack;
     }
 
-}
+    template struct WaveStackT<9>;
+    template struct WaveStackT<10>;
+    template struct WaveStackT<11>;
+    template struct WaveStackT<12>;
 
+}
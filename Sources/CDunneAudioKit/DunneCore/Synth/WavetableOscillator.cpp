@@ -0,0 +1,155 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "WavetableOscillator.h"
+#include "kiss_fftr.h"
+
+#include <algorithm>
+
+namespace DunneCore
+{
+
+    void Wavetable::init(const float *pSamples, int sampleCount, int frameLength)
+    {
+        frames.clear();
+        if (pSamples == 0 || frameLength < 2) return;
+
+        const int stackLength = 1 << WaveStack::maxBits;
+        std::vector<float> frame(stackLength);
+
+        // Resampling takes the frame's spectrum at its own length, keeps the harmonics below both
+        // Nyquist limits, and transforms back at the stack's length. Frame lengths needn't be even,
+        // so these are complex transforms of real data.
+        const bool isResampling = frameLength != stackLength;
+        const int harmonicCount = (std::min(frameLength, stackLength) - 1) / 2;
+        kiss_fft_cfg forward = 0, inverse = 0;
+        std::vector<kiss_fft_cpx> frameData, spectrum, stackSpectrum, stackData;
+        if (isResampling)
+        {
+            forward = kiss_fft_alloc(frameLength, 0, 0, 0);
+            inverse = kiss_fft_alloc(stackLength, 1, 0, 0);
+            frameData.resize(frameLength);
+            spectrum.resize(frameLength);
+            stackSpectrum.resize(stackLength);
+            stackData.resize(stackLength);
+        }
+
+        for (int frameStart = 0; frameStart + frameLength <= sampleCount; frameStart += frameLength)
+        {
+            const float *pFrame = pSamples + frameStart;
+            if (!isResampling)
+            {
+                for (int i=0; i < stackLength; i++) frame[i] = pFrame[i];
+            }
+            else
+            {
+                for (int i=0; i < frameLength; i++) frameData[i] = { pFrame[i], 0.0f };
+                kiss_fft(forward, frameData.data(), spectrum.data());
+
+                std::fill(stackSpectrum.begin(), stackSpectrum.end(), kiss_fft_cpx{ 0.0f, 0.0f });
+                stackSpectrum[0] = spectrum[0];
+                for (int h=1; h <= harmonicCount; h++)
+                {
+                    stackSpectrum[h] = spectrum[h];
+                    stackSpectrum[stackLength - h] = spectrum[frameLength - h];
+                }
+                kiss_fft(inverse, stackSpectrum.data(), stackData.data());
+
+                const float scale = 1.0f / frameLength;
+                for (int i=0; i < stackLength; i++) frame[i] = scale * stackData[i].r;
+            }
+
+            // identical frames (e.g. in another synth instance's copy of the same table) are shared
+            frames.push_back(WaveStack::getShared(frame));
+        }
+
+        if (isResampling)
+        {
+            kiss_fft_free(inverse);
+            kiss_fft_free(forward);
+        }
+    }
+
+    void WavetableOscillator::init(double sampleRate, const Wavetable *pTable)
+    {
+        sampleRateHz = sampleRate;
+        pWavetable = pTable;
+        octave = 0;
+        phase = 0;
+        phaseDelta = 0.0f;
+        phaseDeltaMultiplier = 1.0f;
+        position = 0.0f;
+    }
+
+    void WavetableOscillator::setFrequency(float frequency)
+    {
+        phaseDelta = (float)(double(frequency) / sampleRateHz);
+        octave = WaveStack::octaveFor(phaseDelta);
+        if (octave >= WaveStack::maxBits) octave = WaveStack::maxBits - 1;
+    }
+
+    void WavetableOscillator::setPosition(float newPosition)
+    {
+        if (newPosition < 0.0f) newPosition = 0.0f;
+        if (newPosition > 1.0f) newPosition = 1.0f;
+        position = newPosition;
+    }
+
+    void WavetableOscillator::getSamples(int sampleCount, float *pOut, float newPosition)
+    {
+        int frameCount = pWavetable ? pWavetable->frameCount() : 0;
+        if (frameCount == 0 || sampleCount <= 0)
+        {
+            for (int i=0; i < sampleCount; i++) pOut[i] = 0.0f;
+            setPosition(newPosition);
+            return;
+        }
+
+        if (newPosition < 0.0f) newPosition = 0.0f;
+        if (newPosition > 1.0f) newPosition = 1.0f;
+
+        // morph position expressed in frames, so the integer part selects the frame pair
+        const int lastFrame = frameCount - 1;
+        float framePosition = position * lastFrame;
+        float framePositionDelta = (newPosition - position) * lastFrame / sampleCount;
+
+        const int tableBits = WaveStack::maxBits - octave;
+        const uint32_t indexMask = (1u << tableBits) - 1;
+        const uint32_t increment = WaveStack::phaseIncrement(double(phaseDeltaMultiplier) * phaseDelta);
+        const auto& frames = pWavetable->frames;
+
+        // In runs of up to runLength samples: first each frame's own interpolated samples, read at
+        // the same index, then the morph between them, as a plain loop across the run.
+        const int runLength = 64;
+        float frameA[runLength], frameB[runLength], morph[runLength];
+        for (int runStart=0; runStart < sampleCount; runStart += runLength)
+        {
+            const int count = std::min(sampleCount - runStart, runLength);
+            for (int i=0; i < count; i++)
+            {
+                int frameIndex = int(framePosition);
+                if (frameIndex >= lastFrame) frameIndex = lastFrame > 0 ? lastFrame - 1 : 0;
+                int nextFrameIndex = frameIndex < lastFrame ? frameIndex + 1 : frameIndex;
+                morph[i] = framePosition - frameIndex;
+
+                const float *pA = frames[frameIndex]->pData[octave];
+                const float *pB = frames[nextFrameIndex]->pData[octave];
+
+                // both frames are read at the same index, so the index math is done only once
+                uint32_t ri = phase >> (32 - tableBits);
+                uint32_t rj = (ri + 1) & indexMask;
+                float f = float((phase << tableBits) >> 8) * (1.0f / (1 << 24));
+                frameA[i] = pA[ri] + f * (pA[rj] - pA[ri]);
+                frameB[i] = pB[ri] + f * (pB[rj] - pB[ri]);
+
+                phase += increment;
+                framePosition += framePositionDelta;
+            }
+
+            float *pRunOut = pOut + runStart;
+            for (int i=0; i < count; i++) pRunOut[i] = frameA[i] + morph[i] * (frameB[i] - frameA[i]);
+        }
+
+        position = newPosition;
+    }
+
+}
@@ -0,0 +1,9 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "FastMathFunctions.h"
+#include "FastMath.h"
+
+float akFastExp2(float x) { return DunneCore::fastExp2(x); }
+float akFastLog2(float x) { return DunneCore::fastLog2(x); }
+float akFastSin(float x) { return DunneCore::fastSin(x); }
+float akFastTan(float x) { return DunneCore::fastTan(x); }
@@ -4,6 +4,8 @@
 #import <AudioUnit/AudioUnit.h>
 #import <AVFoundation/AVFoundation.h>
 #include <math.h>
+#include <algorithm>
+#include <atomic>
 
 #include "ModulatedDelayDSP.h"
 #import "DSPBase.h"
@@ -16,6 +18,7 @@ const float kChorus_DefaultFrequency = kChorusDefaultModFreqHz;
 const float kChorus_DefaultDepth = kChorusDefaultDepth;
 const float kChorus_DefaultFeedback = kChorusDefaultFeedback;
 const float kChorus_DefaultDryWetMix = kChorusDefaultMix;
+const float kChorus_DefaultTapCount = kChorusDefaultTapCount;
 
 const float kChorus_MinFrequency = kChorusMinModFreqHz;
 const float kChorus_MaxFrequency = kChorusMaxModFreqHz;
@@ -25,6 +28,8 @@ const float kChorus_MinDepth     = kChorusMinDepth;
 const float kChorus_MaxDepth     = kChorusMaxDepth;
 const float kChorus_MinDryWetMix = kChorusMinDryWetMix;
 const float kChorus_MaxDryWetMix = kChorusMaxDryWetMix;
+const float kChorus_MinTapCount  = kChorusMinTapCount;
+const float kChorus_MaxTapCount  = kChorusMaxTapCount;
 
 const float kFlanger_DefaultFrequency = kFlangerDefaultModFreqHz;
 const float kFlanger_DefaultDepth = kFlangerDefaultDepth;
@@ -50,9 +55,38 @@ private:
     ParameterRamper dryWetMixRamp;
     ModulatedDelay delay;
 
+    // set on the parameter thread, handed to delay at the top of process(), on the render thread
+    std::atomic<int> tapCount{kChorusDefaultTapCount};
+    std::atomic<int> interpolation{DunneCore::kLinearInterpolation};
+
 public:
     ModulatedDelayDSP(ModulatedDelayType type);
 
+    void setParameter(AUParameterAddress address, AUValue value, bool immediate) override {
+        if (address == ModulatedDelayParameterTapCount) {
+            tapCount = std::max(kChorusMinTapCount, std::min(int(value + 0.5f), kChorusMaxTapCount));
+        }
+        else if (address == ModulatedDelayParameterInterpolation) {
+            int kind = int(value + 0.5f);
+            if (kind >= 0 && kind < DunneCore::kDelayInterpolationCount) interpolation = kind;
+        }
+        else {
+            DSPBase::setParameter(address, value, immediate);
+        }
+    }
+
+    float getParameter(uint64_t address) override {
+        if (address == ModulatedDelayParameterTapCount) {
+            return float(tapCount.load());
+        }
+        else if (address == ModulatedDelayParameterInterpolation) {
+            return float(interpolation.load());
+        }
+        else {
+            return DSPBase::getParameter(address);
+        }
+    }
+
     void init(int channelCount, double sampleRate) override;
 
     void deinit() override;
@@ -92,6 +126,10 @@ void ModulatedDelayDSP::process(FrameRange range)
     outBuffers[1] = (float *)outputBufferList->mBuffers[1].mData + range.start;
     unsigned channelCount = outputBufferList->mNumberBuffers;
 
+    delay.setTapCount(tapCount.load());
+    auto kind = DunneCore::DelayInterpolation(interpolation.load());
+    if (kind != delay.getInterpolation()) delay.setInterpolation(kind);
+
     if (!isStarted)
     {
         // effect bypassed: just copy input to output
@@ -0,0 +1,21 @@
+// Copyright AudioKit. All Rights Reserved.
+
+#include "ModulatedDelayNullTestFunctions.h"
+#include "DunneCore/Modulated Delay/ModulatedDelayNullTest.h"
+
+#include <stdint.h>
+#include <vector>
+
+double akModulatedDelayNullTestDb(ModulatedDelayType type, float modFrequencyHz, float depth,
+                                  double sampleRate)
+{
+    std::vector<float> noise(1 << 16);
+    uint32_t random = 12345;
+    for (float& sample : noise)
+    {
+        random = random * 1664525u + 1013904223u;
+        sample = (random >> 8) / 16777216.0f - 0.5f;
+    }
+    return DunneCore::modulatedDelayNullTestDb(type, modFrequencyHz, depth,
+                                               noise.data(), int(noise.size()), sampleRate);
+}
@@ -258,6 +258,12 @@ void SamplerDSP::setParameter(AUParameterAddress address, float value, bool imme
         case SamplerParameterFilterEnvelopeVelocityScaling:
             sampler->filterEnvelopeVelocityScaling = value;
             break;
+        case SamplerParameterFilterType:
+            sampler->filterType = int(value + 0.5f);
+            break;
+        case SamplerParameterAmpEnvelopeAudioRate:
+            sampler->isAmpEnvelopeAudioRate = value > 0.5f;
+            break;
     }
 }
 
@@ -336,6 +342,10 @@ float SamplerDSP::getParameter(AUParameterAddress address) __attribute__((no_san
             return sampler->keyTracking;
         case SamplerParameterFilterEnvelopeVelocityScaling:
             return sampler->filterEnvelopeVelocityScaling;
+        case SamplerParameterFilterType:
+            return float(sampler->filterType);
+        case SamplerParameterAmpEnvelopeAudioRate:
+            return sampler->isAmpEnvelopeAudioRate ? 1.0f : 0.0f;
     }
     return 0;
 }
@@ -380,11 +390,13 @@ void SamplerDSP::handleMIDIEvent(const AUMIDIEvent &midiEvent)
 void SamplerDSP::process(FrameRange range)
 {
 
-    float *pLeft = (float *)outputBufferList->mBuffers[0].mData + range.start;
-    float *pRight = (float *)outputBufferList->mBuffers[1].mData + range.start;
+    // a single output buffer gets the sampler's mono mix
+    unsigned channelCount = outputBufferList->mNumberBuffers > 1 ? 2 : 1;
 
-    memset(pLeft, 0, range.count * sizeof(float));
-    memset(pRight, 0, range.count * sizeof(float));
+    for (unsigned ch = 0; ch < channelCount; ch++) {
+        float *pOut = (float *)outputBufferList->mBuffers[ch].mData + range.start;
+        memset(pOut, 0, range.count * sizeof(float));
+    }
 
     sampler.update();
 
@@ -421,10 +433,9 @@ void SamplerDSP::process(FrameRange range)
         sampler->glideRate = (float)glideRateRamp.getValue();
 
         // get data
-        float *outBuffers[2];
-        outBuffers[0] = (float *)outputBufferList->mBuffers[0].mData + frameOffset;
-        outBuffers[1] = (float *)outputBufferList->mBuffers[1].mData + frameOffset;
-        unsigned channelCount = outputBufferList->mNumberBuffers;
+        float *outBuffers[2] = { nullptr, nullptr };
+        for (unsigned ch = 0; ch < channelCount; ch++)
+            outBuffers[ch] = (float *)outputBufferList->mBuffers[ch].mData + frameOffset;
         sampler->render(channelCount, chunkSize, outBuffers);
     }
 }
@@ -462,4 +473,6 @@ AK_REGISTER_PARAMETER(SamplerParameterMonophonic)
 AK_REGISTER_PARAMETER(SamplerParameterLegato)
 AK_REGISTER_PARAMETER(SamplerParameterKeyTrackingFraction)
 AK_REGISTER_PARAMETER(SamplerParameterFilterEnvelopeVelocityScaling)
+AK_REGISTER_PARAMETER(SamplerParameterFilterType)
+AK_REGISTER_PARAMETER(SamplerParameterAmpEnvelopeAudioRate)
 AK_REGISTER_PARAMETER(SamplerParameterRampDuration)
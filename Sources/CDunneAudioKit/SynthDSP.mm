@@ -16,6 +16,7 @@ struct SynthDSP : DSPBase, CoreSynth
     LinearParameterRamp filterCutoffRamp;
     LinearParameterRamp filterStrengthRamp;
     LinearParameterRamp filterResonanceRamp;
+    LinearParameterRamp wavetablePositionRamp;
 
     SynthDSP();
     void init(int channelCount, double sampleRate) override;
@@ -32,6 +33,30 @@ DSPRef akSynthCreateDSP() {
     return new SynthDSP();
 }
 
+void akSynthLoadWavetable(DSPRef pDSP, const float *pSamples, int sampleCount, int frameLength) {
+    ((SynthDSP*)pDSP)->loadWavetable(pSamples, sampleCount, frameLength);
+}
+
+bool akSynthAddModulationRoute(DSPRef pDSP, int source, int destination, float amount) {
+    return ((SynthDSP*)pDSP)->addModulationRoute(source, destination, amount);
+}
+
+void akSynthClearModulationRoutes(DSPRef pDSP) {
+    ((SynthDSP*)pDSP)->clearModulationRoutes();
+}
+
+void akSynthSetDefaultModulationRoutes(DSPRef pDSP) {
+    ((SynthDSP*)pDSP)->setDefaultModulationRoutes();
+}
+
+void akSynthSetVoiceCount(DSPRef pDSP, int voiceCount) {
+    ((SynthDSP*)pDSP)->setVoiceCount(voiceCount);
+}
+
+void akSynthSetRenderThreadCount(DSPRef pDSP, int threadCount) {
+    ((SynthDSP*)pDSP)->setRenderThreadCount(threadCount);
+}
+
 SynthDSP::SynthDSP() : DSPBase(/*inputBusCount*/0), CoreSynth()
 {
     masterVolumeRamp.setTarget(1.0, true);
@@ -39,6 +64,7 @@ SynthDSP::SynthDSP() : DSPBase(/*inputBusCount*/0), CoreSynth()
     vibratoDepthRamp.setTarget(0.0, true);
     filterCutoffRamp.setTarget(1000.0, true);
     filterResonanceRamp.setTarget(1.0, true);
+    wavetablePositionRamp.setTarget(0.0, true);
 }
 
 void SynthDSP::init(int channelCount, double sampleRate)
@@ -62,6 +88,7 @@ void SynthDSP::setParameter(uint64_t address, float value, bool immediate)
             vibratoDepthRamp.setRampDuration(value, sampleRate);
             filterCutoffRamp.setRampDuration(value, sampleRate);
             filterResonanceRamp.setRampDuration(value, sampleRate);
+            wavetablePositionRamp.setRampDuration(value, sampleRate);
             break;
 
         case SynthParameterMasterVolume:
@@ -82,6 +109,9 @@ void SynthDSP::setParameter(uint64_t address, float value, bool immediate)
         case SynthParameterFilterResonance:
             filterResonanceRamp.setTarget(pow(10.0, -0.05 * value), immediate);
             break;
+        case SynthParameterWavetablePosition:
+            wavetablePositionRamp.setTarget(value, immediate);
+            break;
 
         case SynthParameterAttackDuration:
             setAmpAttackDurationSeconds(value);
@@ -108,6 +138,12 @@ void SynthDSP::setParameter(uint64_t address, float value, bool immediate)
         case SynthParameterFilterReleaseDuration:
             setFilterReleaseDurationSeconds(value);
             break;
+        case SynthParameterWavetableMixLevel:
+            setWavetableMixLevel(value);
+            break;
+        case SynthParameterFilterType:
+            setFilterType(int(value + 0.5f));
+            break;
     }
 }
 
@@ -129,6 +165,8 @@ float SynthDSP::getParameter(uint64_t address)
             return filterStrengthRamp.getTarget();
         case SynthParameterFilterResonance:
             return -20.0f * log10(filterResonanceRamp.getTarget());
+        case SynthParameterWavetablePosition:
+            return wavetablePositionRamp.getTarget();
 
         case SynthParameterAttackDuration:
             return getAmpAttackDurationSeconds();
@@ -147,6 +185,10 @@ float SynthDSP::getParameter(uint64_t address)
             return getFilterSustainFraction();
         case SynthParameterFilterReleaseDuration:
             return getFilterReleaseDurationSeconds();
+        case SynthParameterWavetableMixLevel:
+            return getWavetableMixLevel();
+        case SynthParameterFilterType:
+            return float(getFilterType());
     }
     return 0;
 }
@@ -202,6 +244,8 @@ void SynthDSP::process(FrameRange range)
         cutoffEnvelopeStrength = (float)filterStrengthRamp.getValue();
         filterResonanceRamp.advanceTo(now + frameOffset);
         linearResonance = (float)filterResonanceRamp.getValue();
+        wavetablePositionRamp.advanceTo(now + frameOffset);
+        wavetablePosition = (float)wavetablePositionRamp.getValue();
 
         // get data
         float *outBuffers[2];
@@ -227,4 +271,7 @@ AK_REGISTER_PARAMETER(SynthParameterFilterAttackDuration)
 AK_REGISTER_PARAMETER(SynthParameterFilterDecayDuration)
 AK_REGISTER_PARAMETER(SynthParameterFilterSustainLevel)
 AK_REGISTER_PARAMETER(SynthParameterFilterReleaseDuration)
+AK_REGISTER_PARAMETER(SynthParameterWavetableMixLevel)
+AK_REGISTER_PARAMETER(SynthParameterFilterType)
+AK_REGISTER_PARAMETER(SynthParameterWavetablePosition)
 AK_REGISTER_PARAMETER(SynthParameterRampDuration)
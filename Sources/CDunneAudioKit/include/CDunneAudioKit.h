@@ -9,3 +9,6 @@
 
 #import "Sampler_Typedefs.h"
 #import "SamplerDSP.h"
+
+#import "FastMathFunctions.h"
+#import "ModulatedDelayNullTestFunctions.h"
@@ -0,0 +1,20 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// The DunneCore FastMath approximations (see DunneCore/Common/FastMath.h), callable from C and
+// Swift, so the tests can check their error bounds. This file is safe to include in either
+// (Objective-)C or C++ contexts.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+float akFastExp2(float x);
+float akFastLog2(float x);
+float akFastSin(float x);
+float akFastTan(float x);
+
+#ifdef __cplusplus
+}
+#endif
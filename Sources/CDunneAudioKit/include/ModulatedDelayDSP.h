@@ -10,6 +10,8 @@ typedef NS_ENUM(AUParameterAddress, ModulatedDelayParameter) {
     ModulatedDelayParameterDepth,
     ModulatedDelayParameterFeedback,
     ModulatedDelayParameterDryWetMix,
+    ModulatedDelayParameterTapCount,
+    ModulatedDelayParameterInterpolation,
 };
 
 // constants
@@ -17,6 +19,7 @@ extern const float kChorus_DefaultFrequency;
 extern const float kChorus_DefaultDepth;
 extern const float kChorus_DefaultFeedback;
 extern const float kChorus_DefaultDryWetMix;
+extern const float kChorus_DefaultTapCount;
 
 extern const float kChorus_MinFrequency;
 extern const float kChorus_MaxFrequency;
@@ -26,6 +29,8 @@ extern const float kChorus_MinDepth;
 extern const float kChorus_MaxDepth;
 extern const float kChorus_MinDryWetMix;
 extern const float kChorus_MaxDryWetMix;
+extern const float kChorus_MinTapCount;
+extern const float kChorus_MaxTapCount;
 
 extern const float kFlanger_DefaultFrequency;
 extern const float kFlanger_MinFrequency;
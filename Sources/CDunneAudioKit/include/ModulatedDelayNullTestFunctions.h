@@ -0,0 +1,23 @@
+// Copyright AudioKit. All Rights Reserved.
+
+// The null test for the chorus and flanger's control-rate LFO (see DunneCore/Modulated Delay/
+// ModulatedDelayNullTest.h), callable from C and Swift, so the tests can check it. This file is
+// safe to include in either (Objective-)C or C++ contexts.
+
+#pragma once
+
+#include "ModulatedDelay_Typedefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The difference, in dB relative to the signal, between the effect and the same with its LFO
+/// computed every sample, on 65536 samples of white noise (the hardest signal to null) at the
+/// given sample rate.
+double akModulatedDelayNullTestDb(ModulatedDelayType type, float modFrequencyHz, float depth,
+                                  double sampleRate);
+
+#ifdef __cplusplus
+}
+#endif
@@ -42,6 +42,8 @@ typedef NS_ENUM(AUParameterAddress, SamplerParameter)
     SamplerParameterLegato,
     SamplerParameterKeyTrackingFraction,
     SamplerParameterFilterEnvelopeVelocityScaling,
+    SamplerParameterFilterType,
+    SamplerParameterAmpEnvelopeAudioRate,
     
     // ensure this is always last in the list, to simplify parameter addressing
     SamplerParameterRampDuration,
@@ -26,6 +26,9 @@ typedef NS_ENUM(AUParameterAddress, SynthParameter)
     SynthParameterFilterDecayDuration,
     SynthParameterFilterSustainLevel,
     SynthParameterFilterReleaseDuration,
+    SynthParameterWavetableMixLevel,
+    SynthParameterFilterType,
+    SynthParameterWavetablePosition,    // ramped; added last to keep existing addresses stable
 
     // ensure this is always last in the list, to simplify parameter addressing
     SynthParameterRampDuration,
@@ -33,4 +36,20 @@ typedef NS_ENUM(AUParameterAddress, SynthParameter)
 
 CF_EXTERN_C_BEGIN
 DSPRef akSynthCreateDSP(void);
+
+/// Copies the samples; the wavetable is built in the background and used once ready.
+void akSynthLoadWavetable(DSPRef pDSP, const float *pSamples, int sampleCount, int frameLength);
+
+/// Modulation routes, as CoreSynth::addModulationRoute(); source and destination are
+/// DunneCore::ModulationSource and ModulationDestination values. Returns false if the route
+/// can't be added. Safe to call while rendering.
+bool akSynthAddModulationRoute(DSPRef pDSP, int source, int destination, float amount);
+void akSynthClearModulationRoutes(DSPRef pDSP);
+void akSynthSetDefaultModulationRoutes(DSPRef pDSP);
+
+/// Number of voices, 1 to 1024 (default 32), from the next time render resources are allocated.
+void akSynthSetVoiceCount(DSPRef pDSP, int voiceCount);
+
+/// Number of threads to render voices on, from the next time render resources are allocated.
+void akSynthSetRenderThreadCount(DSPRef pDSP, int threadCount);
 CF_EXTERN_C_END
\ No newline at end of file
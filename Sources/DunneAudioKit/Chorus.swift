@@ -67,6 +67,33 @@ public class Chorus: Node {
     /// Dry Wet Mix (fraction)
     @Parameter(dryWetMixDef) public var dryWetMix: AUValue
 
+    /// Specification details for interpolation
+    public static let interpolationDef = NodeParameterDef(
+        identifier: "interpolation",
+        name: "Interpolation",
+        address: ModulatedDelayParameter.interpolation.rawValue,
+        defaultValue: 0,
+        range: 0 ... 3,
+        unit: .indexed,
+        flags: [.flag_IsReadable, .flag_IsWritable])
+
+    /// How the delay is read between samples, cheapest first: 0 linear, 1 allpass, 2 Hermite,
+    /// 3 Lagrange. The higher orders keep more of the highs.
+    @Parameter(interpolationDef) public var interpolation: AUValue
+
+    /// Specification details for taps
+    public static let tapsDef = NodeParameterDef(
+        identifier: "taps",
+        name: "Taps",
+        address: ModulatedDelayParameter.tapCount.rawValue,
+        defaultValue: kChorus_DefaultTapCount,
+        range: kChorus_MinTapCount ... kChorus_MaxTapCount,
+        unit: .indexed,
+        flags: [.flag_IsReadable, .flag_IsWritable])
+
+    /// Number of chorus voices (ensemble taps), 1-8, their modulation evenly out of phase
+    @Parameter(tapsDef) public var taps: AUValue
+
     // MARK: - Initialization
 
     /// Initialize this chorus node
@@ -77,13 +104,15 @@ public class Chorus: Node {
     ///   - depth: depth of modulation (fraction)
     ///   - feedback: feedback fraction
     ///   - dryWetMix: fraction of wet signal in mix
+    ///   - taps: number of chorus voices, 1-8
     ///
     public init(
         _ input: Node,
         frequency: AUValue = frequencyDef.defaultValue,
         depth: AUValue = depthDef.defaultValue,
         feedback: AUValue = feedbackDef.defaultValue,
-        dryWetMix: AUValue = dryWetMixDef.defaultValue
+        dryWetMix: AUValue = dryWetMixDef.defaultValue,
+        taps: AUValue = tapsDef.defaultValue
     ) {
         self.input = input
         
@@ -93,5 +122,6 @@ public class Chorus: Node {
         self.depth = depth
         self.feedback = feedback
         self.dryWetMix = dryWetMix
+        self.taps = taps
     }
 }
@@ -67,6 +67,20 @@ public class Flanger: Node {
     /// Dry Wet Mix (fraction)
     @Parameter(dryWetMixDef) public var dryWetMix: AUValue
 
+    /// Specification details for interpolation
+    public static let interpolationDef = NodeParameterDef(
+        identifier: "interpolation",
+        name: "Interpolation",
+        address: ModulatedDelayParameter.interpolation.rawValue,
+        defaultValue: 0,
+        range: 0 ... 3,
+        unit: .indexed,
+        flags: [.flag_IsReadable, .flag_IsWritable])
+
+    /// How the delay is read between samples, cheapest first: 0 linear, 1 allpass, 2 Hermite,
+    /// 3 Lagrange. The higher orders keep more of the highs.
+    @Parameter(interpolationDef) public var interpolation: AUValue
+
     // MARK: - Initialization
 
     /// Initialize this flanger node
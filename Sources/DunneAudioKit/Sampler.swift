@@ -410,6 +410,34 @@ public class Sampler: Node {
     /// filterEnvelopeVelocityScaling (fraction 0.0 to 1.0)
     @Parameter(filterEnvelopeVelocityScalingDef) public var filterEnvelopeVelocityScaling: AUValue
 
+    /// Specification details for filterType
+    public static let filterTypeDef = NodeParameterDef(
+        identifier: "filterType",
+        name: "Filter Type",
+        address: akGetParameterAddress("SamplerParameterFilterType"),
+        defaultValue: 0,
+        range: 0 ... 1,
+        unit: .indexed,
+        flags: nonRampFlags)
+
+    /// filterType (0 = resonant low-pass, 1 = state-variable). The state-variable filter stays
+    /// smooth under fast cutoff modulation, e.g. by the filter envelope.
+    @Parameter(filterTypeDef) public var filterType: AUValue
+
+    /// Specification details for ampEnvelopeAudioRate
+    public static let ampEnvelopeAudioRateDef = NodeParameterDef(
+        identifier: "ampEnvelopeAudioRate",
+        name: "Amp Envelope Audio Rate",
+        address: akGetParameterAddress("SamplerParameterAmpEnvelopeAudioRate"),
+        defaultValue: 0,
+        range: 0 ... 1,
+        unit: .boolean,
+        flags: nonRampFlags)
+
+    /// Run the amplitude envelope at audio rate (boolean, 0.0 for false or 1.0 for true), for
+    /// click-free very short attacks, at some extra CPU cost per voice
+    @Parameter(ampEnvelopeAudioRateDef) public var ampEnvelopeAudioRate: AUValue
+
     // MARK: - Initialization
 
     /// Initialize without any descriptors
@@ -89,6 +89,18 @@ public class Synth: Node {
     
     /// Filter resonance (dB)
     @Parameter(filterResonanceDef) public var filterResonance: AUValue
+
+    /// Specification details for wavetablePosition
+    public static let wavetablePositionDef = NodeParameterDef(
+        identifier: "wavetablePosition",
+        name: "Wavetable Position",
+        address: akGetParameterAddress("SynthParameterWavetablePosition"),
+        defaultValue: 0,
+        range: 0 ... 1,
+        unit: .generic)
+
+    /// Wavetable morph position (fraction: 0 = first frame, 1 = last frame)
+    @Parameter(wavetablePositionDef) public var wavetablePosition: AUValue
     
     /// Specification details for attackDuration
     public static let attackDurationDef = NodeParameterDef(
@@ -188,6 +200,31 @@ public class Synth: Node {
     /// Filter Amplitude release duration (seconds)
     @Parameter(filterReleaseDurationDef) public var filterReleaseDuration: AUValue
 
+    /// Specification details for wavetableMixLevel
+    public static let wavetableMixLevelDef = NodeParameterDef(
+        identifier: "wavetableMixLevel",
+        name: "Wavetable Mix Level",
+        address: akGetParameterAddress("SynthParameterWavetableMixLevel"),
+        defaultValue: 0,
+        range: 0 ... 1,
+        unit: .generic)
+
+    /// Wavetable oscillator level (fraction), 0 until a wavetable is loaded
+    @Parameter(wavetableMixLevelDef) public var wavetableMixLevel: AUValue
+
+    /// Specification details for filterType
+    public static let filterTypeDef = NodeParameterDef(
+        identifier: "filterType",
+        name: "Filter Type",
+        address: akGetParameterAddress("SynthParameterFilterType"),
+        defaultValue: 0,
+        range: 0 ... 2,
+        unit: .indexed)
+
+    /// Filter type (0 = resonant low-pass, 1 = state-variable, 2 = ladder). The state-variable and
+    /// ladder filters stay smooth under fast cutoff modulation, e.g. by the filter envelope.
+    @Parameter(filterTypeDef) public var filterType: AUValue
+
     // MARK: - Initialization
 
     /// Initialize this synth node
@@ -208,6 +245,12 @@ public class Synth: Node {
     ///   - filterDecayDuration: seconds, 0.0 - 10.0
     ///   - filterSustainLevel: 0.0 - 1.0
     ///   - filterReleaseDuration: seconds, 0.0 - 10.0
+    ///   - wavetablePosition: 0.0 - 1.0, morph position between first and last wavetable frames
+    ///   - wavetableMixLevel: 0.0 - 1.0, level of wavetable oscillator
+    ///   - filterType: 0 = resonant low-pass, 1 = state-variable, 2 = ladder
+    ///   - voiceCount: polyphony, 1 - 1024; a note played again while releasing takes another voice if one is free
+    ///   - renderThreadCount: threads to render voices on, 1 (the audio thread alone) up to the core count;
+    ///     the output is the same for any count
     ///
     public init(
         masterVolume: AUValue = masterVolumeDef.defaultValue,
@@ -224,10 +267,17 @@ public class Synth: Node {
         filterAttackDuration: AUValue = filterAttackDurationDef.defaultValue,
         filterDecayDuration: AUValue = filterDecayDurationDef.defaultValue,
         filterSustainLevel: AUValue = filterSustainLevelDef.defaultValue,
-        filterReleaseDuration: AUValue = filterReleaseDurationDef.defaultValue
+        filterReleaseDuration: AUValue = filterReleaseDurationDef.defaultValue,
+        wavetablePosition: AUValue = wavetablePositionDef.defaultValue,
+        wavetableMixLevel: AUValue = wavetableMixLevelDef.defaultValue,
+        filterType: AUValue = filterTypeDef.defaultValue,
+        voiceCount: Int = 32,
+        renderThreadCount: Int = 1
     ) {
         
         setupParameters()
+        akSynthSetVoiceCount(au.dsp, Int32(voiceCount))
+        akSynthSetRenderThreadCount(au.dsp, Int32(renderThreadCount))
         
         self.masterVolume = masterVolume
         self.pitchBend = pitchBend
@@ -243,9 +293,74 @@ public class Synth: Node {
         self.filterDecayDuration = filterDecayDuration
         self.filterSustainLevel = filterSustainLevel
         self.filterReleaseDuration = filterReleaseDuration
+        self.wavetablePosition = wavetablePosition
+        self.wavetableMixLevel = wavetableMixLevel
+        self.filterType = filterType
         
     }
 
+    /// Load a wavetable for the wavetable oscillator, from a file of consecutive single-cycle frames
+    /// (first channel only). The wavetable is prepared in the background, and used as soon as it is ready.
+    /// - Parameters:
+    ///   - file: Audio file containing the frames
+    ///   - frameLength: Number of samples per frame
+    public func loadWavetable(file: AVAudioFile, frameLength: Int = 2048) {
+        guard let floatChannelData = file.toFloatChannelData(), let samples = floatChannelData.first else { return }
+        samples.withUnsafeBufferPointer { data in
+            akSynthLoadWavetable(au.dsp, data.baseAddress, Int32(samples.count), Int32(frameLength))
+        }
+    }
+
+    /// What a modulation route reads, once per 16-sample chunk
+    public enum ModulationSource: Int32 {
+        /// Amplitude envelope, 0 to 1
+        case ampEnvelope
+        /// Filter envelope, 0 to 1
+        case filterEnvelope
+        /// Multi-segment "pump" envelope, 0 to 1
+        case pumpEnvelope
+        /// The shared vibrato LFO, -1 to 1
+        case vibratoLFO
+        /// Each voice's own sine LFO, restarted with every note, -1 to 1
+        case voiceLFO
+        /// Note velocity, 0 to 1
+        case velocity
+    }
+
+    /// What a modulation route changes
+    public enum ModulationDestination: Int32 {
+        /// Adds amount * source to filterCutoff, scaled by filterStrength
+        case cutoff
+        /// Adds amount * source semitones
+        case pitch
+        /// Multiplies the volume by (1 - amount) + amount * source
+        case amp
+    }
+
+    /// Add a modulation route. The default routes are velocity and amp envelope to amp, and filter
+    /// envelope to cutoff, each by 1.
+    /// - Parameters:
+    ///   - source: What the route reads
+    ///   - destination: What the route changes
+    ///   - amount: How much
+    /// - Returns: false if the route can't be added (at most 16 routes)
+    @discardableResult
+    public func addModulationRoute(source: ModulationSource,
+                                   destination: ModulationDestination,
+                                   amount: AUValue) -> Bool {
+        akSynthAddModulationRoute(au.dsp, source.rawValue, destination.rawValue, amount)
+    }
+
+    /// Remove all modulation routes, including the default ones
+    public func clearModulationRoutes() {
+        akSynthClearModulationRoutes(au.dsp)
+    }
+
+    /// Go back to the default modulation routes
+    public func setDefaultModulationRoutes() {
+        akSynthSetDefaultModulationRoutes(au.dsp)
+    }
+
     /// Play a note on the synth
     /// - Parameters:
     ///   - noteNumber: MIDI Note Number
@@ -0,0 +1,74 @@
+// Copyright AudioKit. All Rights Reserved.
+
+import CDunneAudioKit
+import Foundation
+import XCTest
+
+/// Checks the error bounds documented in FastMath.h, against the double-precision standard library
+class FastMathTests: XCTestCase {
+
+    let sweepCount = 1 << 20
+
+    /// evenly spaced arguments from lo to hi
+    func sweep(_ lo: Double, _ hi: Double, _ body: (Float) -> Void) {
+        for i in 0 ..< sweepCount {
+            body(Float(lo + (hi - lo) * Double(i) / Double(sweepCount - 1)))
+        }
+    }
+
+    func testExp2() {
+        var maxError = 0.0
+        sweep(-126, 126) { x in
+            maxError = max(maxError, abs(Double(akFastExp2(x)) / exp2(Double(x)) - 1))
+        }
+        XCTAssertLessThanOrEqual(maxError, 1.5e-7)
+    }
+
+    func testExp2IsExactForIntegers() {
+        for n in -126 ... 126 {
+            XCTAssertEqual(akFastExp2(Float(n)), Float(exp2(Double(n))))
+        }
+    }
+
+    func testLog2() {
+        var maxError = 0.0
+        sweep(-8, 8) { e in
+            let x = Float(exp2(Double(e)))
+            maxError = max(maxError, abs(Double(akFastLog2(x)) - log2(Double(x))))
+        }
+        XCTAssertLessThanOrEqual(maxError, 3e-7)
+    }
+
+    func testLog2BeyondOctaveEight() {
+        // within one float step of the exact result, over the normal range
+        var maxSteps = 0.0
+        sweep(-125.9, 127.9) { e in
+            let x = Float(exp2(Double(e)))
+            let exact = log2(Double(x))
+            let step = Double(Float(abs(exact)).nextUp - Float(abs(exact)))
+            maxSteps = max(maxSteps, (abs(Double(akFastLog2(x)) - exact) - 3e-7) / step)
+        }
+        XCTAssertLessThanOrEqual(maxSteps, 1)
+    }
+
+    func testSin() {
+        var maxError = 0.0
+        sweep(-64 * Double.pi, 64 * Double.pi) { x in
+            maxError = max(maxError, abs(Double(akFastSin(x)) - sin(Double(x))))
+        }
+        XCTAssertLessThanOrEqual(maxError, 5e-7)
+    }
+
+    func testTan() {
+        var maxError = 0.0
+        var topError = 0.0
+        sweep(0, 0.495 * Double.pi) { x in
+            guard x > 0 else { return }
+            let error = abs(Double(akFastTan(x)) / tan(Double(x)) - 1)
+            if x <= 1.3 { maxError = max(maxError, error) }
+            topError = max(topError, error)
+        }
+        XCTAssertLessThanOrEqual(maxError, 1e-5)
+        XCTAssertLessThanOrEqual(topError, 7e-4)
+    }
+}
@@ -7,13 +7,18 @@ import XCTest
 
 class GenericNodeTests: XCTestCase {
 
+    /// Indexed parameters pick one of several algorithms, so there is nothing to ramp through
+    func sweptParameters(_ node: Node) -> [NodeParameter] {
+        return node.parameters.filter { $0.def.unit != .indexed }
+    }
+
     func nodeParameterTest(md5: String, factory: (Node)->Node, m1MD5: String = "", audition: Bool = false) {
 
         let url = Bundle.module.url(forResource: "12345", withExtension: "wav", subdirectory: "TestResources")!
         let player = AudioPlayer(url: url)!
         let node = factory(player)
 
-        let duration = node.parameters.count + 1
+        let duration = sweptParameters(node).count + 1
 
         let engine = AudioEngine()
         var bigBuffer: AVAudioPCMBuffer? = nil
@@ -31,12 +36,12 @@ class GenericNodeTests: XCTestCase {
             bigBuffer?.append(audio)
         }
 
-        for i in 0 ..< node.parameters.count {
+        for i in 0 ..< sweptParameters(node).count {
 
             let node = factory(player)
             engine.output = node
 
-            let param = node.parameters[i]
+            let param = sweptParameters(node)[i]
 
             node.start()
 
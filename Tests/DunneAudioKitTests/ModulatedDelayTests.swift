@@ -0,0 +1,32 @@
+// Copyright AudioKit. All Rights Reserved.
+
+import CDunneAudioKit
+import XCTest
+
+/// The chorus and flanger run their LFO at a control rate; it must null against a per-sample
+/// LFO at every rate and depth, including the worst case, the fastest rate at full depth, and at
+/// every common sample rate
+class ModulatedDelayTests: XCTestCase {
+
+    let nullThresholdDb = -60.0
+
+    func checkNull(_ type: ModulatedDelayType, maxFrequency: Float, maxDepth: Float) {
+        for sampleRate in [44100, 48000, 96000] as [Double] {
+            for frequency in [0.1, 0.5, 1, 2, 4, 7, maxFrequency] as [Float] {
+                for depth in [0.25, 0.5, maxDepth] as [Float] {
+                    let db = akModulatedDelayNullTestDb(type, frequency, depth, sampleRate)
+                    XCTAssertLessThan(db, nullThresholdDb,
+                                      "at \(frequency) Hz, depth \(depth), \(sampleRate) Hz sample rate")
+                }
+            }
+        }
+    }
+
+    func testChorusNulls() {
+        checkNull(kChorus, maxFrequency: kChorus_MaxFrequency, maxDepth: kChorus_MaxDepth)
+    }
+
+    func testFlangerNulls() {
+        checkNull(kFlanger, maxFrequency: kFlanger_MaxFrequency, maxDepth: kFlanger_MaxDepth)
+    }
+}
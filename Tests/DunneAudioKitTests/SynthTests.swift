@@ -1,6 +1,7 @@
 // Copyright AudioKit. All Rights Reserved.
 #if !os(tvOS)
 
+import AVFoundation
 import AudioKit
 import XCTest
 import DunneAudioKit
@@ -58,5 +59,26 @@ class SynthTests: XCTestCase {
         testMD5(audio)
     }
 
+    func testRenderThreadsGiveIdenticalOutput() {
+        func render(renderThreadCount: Int) -> AVAudioPCMBuffer {
+            let engine = AudioEngine()
+            let synth = Synth(releaseDuration: 0.5, renderThreadCount: renderThreadCount)
+            engine.output = synth
+            let audio = engine.startTest(totalDuration: 2.0)
+            let notes: [MIDINoteNumber] = [36, 43, 48, 52, 55, 59, 60, 64, 67, 71, 72, 76]
+            for note in notes { synth.play(noteNumber: note, velocity: 100) }
+            audio.append(engine.render(duration: 1.0))
+            for note in notes { synth.stop(noteNumber: note) }
+            audio.append(engine.render(duration: 1.0))
+            return audio
+        }
+        let reference = render(renderThreadCount: 1)
+        XCTAssertFalse(reference.isSilent)
+        for threadCount in [2, 4] {
+            XCTAssertEqual(render(renderThreadCount: threadCount).md5, reference.md5,
+                           "\(threadCount) render threads")
+        }
+    }
+
 }
 #endif